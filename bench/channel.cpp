@@ -0,0 +1,72 @@
+#include <asyncio/spsc_channel.h>
+#include <asyncio/thread.h>
+#include <fmt/format.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+namespace {
+    constexpr std::size_t Count{100000};
+    constexpr std::size_t Capacity{1024};
+
+    // The same pipeline for both kinds of channel, so that only the ring and its wakeups differ.
+    template<typename Sender, typename Receiver>
+    asyncio::task::Task<void, std::error_code> pipeline(Sender sender, Receiver receiver) {
+        auto producer = [](Sender s) -> asyncio::task::Task<void, std::error_code> {
+            for (std::size_t i{0}; i < Count; ++i)
+                Z_CO_EXPECT(co_await s.send(i));
+
+            co_return {};
+        }(std::move(sender));
+
+        for (std::size_t i{0}; i < Count; ++i)
+            Z_CO_EXPECT(co_await receiver.receive());
+
+        co_return co_await producer;
+    }
+
+    template<typename Sender, typename Receiver>
+    asyncio::task::Task<void, std::error_code> crossThread(Sender sender, Receiver receiver) {
+        auto producer = asyncio::toThread([sender = std::move(sender)] mutable {
+            for (std::size_t i{0}; i < Count; ++i)
+                zero::error::guard(sender.sendSync(i));
+        });
+
+        for (std::size_t i{0}; i < Count; ++i)
+            Z_CO_EXPECT(co_await receiver.receive());
+
+        co_await producer;
+        co_return {};
+    }
+}
+
+TEST_CASE("channel throughput", "[channel]") {
+    BENCHMARK(fmt::format("mpmc {} elements", Count)) {
+        return asyncio::run([] {
+            auto [sender, receiver] = asyncio::channel<std::size_t>(Capacity);
+            return pipeline(std::move(sender), std::move(receiver));
+        });
+    };
+
+    BENCHMARK(fmt::format("spsc {} elements", Count)) {
+        return asyncio::run([] {
+            auto [sender, receiver] = asyncio::spscChannel<std::size_t>(Capacity);
+            return pipeline(std::move(sender), std::move(receiver));
+        });
+    };
+}
+
+TEST_CASE("channel throughput across threads", "[channel]") {
+    BENCHMARK(fmt::format("mpmc {} elements", Count)) {
+        return asyncio::run([] {
+            auto [sender, receiver] = asyncio::channel<std::size_t>(Capacity);
+            return crossThread(std::move(sender), std::move(receiver));
+        });
+    };
+
+    BENCHMARK(fmt::format("spsc {} elements", Count)) {
+        return asyncio::run([] {
+            auto [sender, receiver] = asyncio::spscChannel<std::size_t>(Capacity);
+            return crossThread(std::move(sender), std::move(receiver));
+        });
+    };
+}
@@ -0,0 +1,59 @@
+#include <asyncio/event_loop.h>
+#include <fmt/format.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <thread>
+#include <list>
+
+TEST_CASE("post from multiple threads", "[event loop]") {
+    constexpr std::size_t count{100000};
+    const auto producers = GENERATE(as<std::size_t>{}, 1, 2, 4, 8);
+
+    BENCHMARK(fmt::format("{} producers x {} callbacks", producers, count)) {
+        const auto eventLoop = std::make_shared<asyncio::EventLoop>(asyncio::EventLoop::make());
+
+        std::size_t counter{0};
+        std::list<std::thread> threads;
+
+        for (std::size_t i{0}; i < producers; ++i) {
+            threads.emplace_back([&] {
+                for (std::size_t j{0}; j < count; ++j) {
+                    eventLoop->post([&] {
+                        if (++counter == producers * count)
+                            eventLoop->stop();
+                    });
+                }
+            });
+        }
+
+        eventLoop->run();
+
+        for (auto &thread: threads)
+            thread.join();
+
+        return counter;
+    };
+}
+
+TEST_CASE("post from event loop thread", "[event loop]") {
+    constexpr std::size_t count{100000};
+
+    BENCHMARK(fmt::format("{} callbacks", count)) {
+        const auto eventLoop = std::make_shared<asyncio::EventLoop>(asyncio::EventLoop::make());
+
+        std::size_t counter{0};
+
+        eventLoop->post([&] {
+            for (std::size_t i{0}; i < count; ++i) {
+                eventLoop->post([&] {
+                    if (++counter == count)
+                        eventLoop->stop();
+                });
+            }
+        });
+
+        eventLoop->run();
+        return counter;
+    };
+}
@@ -0,0 +1,60 @@
+#include <asyncio/sync/mutex.h>
+#include <asyncio/sync/event.h>
+#include <asyncio/event_loop.h>
+#include <fmt/format.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+TEST_CASE("mutex handoff", "[sync]") {
+    constexpr std::size_t count{10000};
+
+    BENCHMARK(fmt::format("2 tasks x {} locks", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            asyncio::sync::Mutex mutex;
+
+            // Holding the lock across a yield makes the other task wait for it every time.
+            const auto contend = [&]() -> asyncio::task::Task<void, std::error_code> {
+                for (std::size_t i{0}; i < count; ++i) {
+                    Z_CO_EXPECT(co_await mutex.lock());
+                    const auto result = co_await asyncio::reschedule();
+                    mutex.unlock();
+                    Z_CO_EXPECT(result);
+                }
+
+                co_return {};
+            };
+
+            Z_CO_EXPECT(co_await asyncio::task::all(contend(), contend()));
+            co_return {};
+        });
+    };
+}
+
+TEST_CASE("event handoff", "[sync]") {
+    constexpr std::size_t count{10000};
+
+    BENCHMARK(fmt::format("{} round trips", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            asyncio::sync::Event ping;
+            asyncio::sync::Event pong;
+
+            auto task = [&]() -> asyncio::task::Task<void, std::error_code> {
+                for (std::size_t i{0}; i < count; ++i) {
+                    Z_CO_EXPECT(co_await ping.wait());
+                    ping.reset();
+                    pong.set();
+                }
+
+                co_return {};
+            }();
+
+            for (std::size_t i{0}; i < count; ++i) {
+                ping.set();
+                Z_CO_EXPECT(co_await pong.wait());
+                pong.reset();
+            }
+
+            co_return co_await task;
+        });
+    };
+}
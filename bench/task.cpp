@@ -0,0 +1,122 @@
+#include <asyncio/time.h>
+#include <fmt/format.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+namespace {
+    asyncio::task::Task<void, std::error_code> noop() {
+        co_return {};
+    }
+
+    asyncio::task::Task<void, std::error_code> chain(const std::size_t depth) {
+        if (depth == 0)
+            co_return {};
+
+        co_return co_await chain(depth - 1);
+    }
+
+    std::vector<asyncio::task::Task<void, std::error_code>> rescheduled(const std::size_t count) {
+        std::vector<asyncio::task::Task<void, std::error_code>> tasks;
+        tasks.reserve(count);
+
+        for (std::size_t i{0}; i < count; ++i)
+            tasks.push_back(asyncio::reschedule());
+
+        return tasks;
+    }
+}
+
+TEST_CASE("await tasks", "[task]") {
+    constexpr std::size_t count{100000};
+
+    BENCHMARK(fmt::format("{} tasks", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            for (std::size_t i{0}; i < count; ++i)
+                Z_CO_EXPECT(co_await noop());
+
+            co_return {};
+        });
+    };
+
+    BENCHMARK(fmt::format("{} spawned tasks", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            for (std::size_t i{0}; i < count; ++i)
+                Z_CO_EXPECT(co_await asyncio::task::spawn(noop));
+
+            co_return {};
+        });
+    };
+}
+
+TEST_CASE("await chain", "[task]") {
+    const auto depth = GENERATE(as<std::size_t>{}, 10, 100, 1000);
+
+    BENCHMARK(fmt::format("depth {}", depth)) {
+        return asyncio::run([=] {
+            return chain(depth);
+        });
+    };
+}
+
+TEST_CASE("task combinators", "[task]") {
+    constexpr std::size_t count{10000};
+
+    BENCHMARK(fmt::format("all of {} tasks", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            Z_CO_EXPECT(co_await asyncio::task::all(rescheduled(count)));
+            co_return {};
+        });
+    };
+
+    BENCHMARK(fmt::format("any of {} tasks", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            // Failures are collected rather than forwarded, since any one success is enough.
+            REQUIRE(co_await asyncio::task::any(rescheduled(count)));
+            co_return {};
+        });
+    };
+
+    BENCHMARK(fmt::format("race of {} tasks", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            Z_CO_EXPECT(co_await asyncio::task::race(rescheduled(count)));
+            co_return {};
+        });
+    };
+}
+
+TEST_CASE("sleep for zero", "[task]") {
+    constexpr std::size_t count{10000};
+
+    BENCHMARK(fmt::format("{} sleeps", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            for (std::size_t i{0}; i < count; ++i)
+                Z_CO_EXPECT(co_await asyncio::sleep(std::chrono::milliseconds{0}));
+
+            co_return {};
+        });
+    };
+}
+
+TEST_CASE("task group scaling", "[task]") {
+    const auto count = GENERATE(as<std::size_t>{}, 1000, 10000, 100000, 1000000);
+
+    BENCHMARK(fmt::format("group of {} tasks", count)) {
+        return asyncio::run([=]() -> asyncio::task::Task<void, std::error_code> {
+            asyncio::task::TaskGroup group;
+
+            for (auto &task: rescheduled(count))
+                group.add(std::move(task));
+
+            co_await group;
+            co_return {};
+        });
+    };
+
+    BENCHMARK(fmt::format("all of {} tasks", count)) {
+        return asyncio::run([=]() -> asyncio::task::Task<void, std::error_code> {
+            Z_CO_EXPECT(co_await asyncio::task::all(rescheduled(count)));
+            co_return {};
+        });
+    };
+}
@@ -0,0 +1,24 @@
+#include <asyncio/thread.h>
+#include <fmt/format.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+TEST_CASE("thread pool round trips", "[thread]") {
+    constexpr std::size_t count{1000};
+
+    BENCHMARK(fmt::format("{} round trips", count)) {
+        return asyncio::run([]() -> asyncio::task::Task<std::size_t, std::error_code> {
+            std::size_t sum{0};
+
+            for (std::size_t i{0}; i < count; ++i) {
+                const auto result = co_await asyncio::toThreadPool([=] {
+                    return i;
+                });
+                Z_CO_EXPECT(result);
+                sum += *result;
+            }
+
+            co_return sum;
+        });
+    };
+}
@@ -6,7 +6,7 @@
 namespace asyncio::binary {
     template<typename T>
         requires (std::is_arithmetic_v<T> && sizeof(T) > 1)
-    task::Task<T, std::error_code> readLE(zero::meta::Trait<IReader> auto &reader) {
+    task::Lazy<T, std::error_code> readLE(zero::meta::Trait<IReader> auto &reader) {
         std::array<std::byte, sizeof(T)> bytes{};
         Z_CO_EXPECT(co_await std::invoke(&IReader::readExactly, reader, bytes));
 
@@ -20,7 +20,7 @@ namespace asyncio::binary {
 
     template<typename T>
         requires (std::is_arithmetic_v<T> && sizeof(T) > 1)
-    task::Task<T, std::error_code> readBE(zero::meta::Trait<IReader> auto &reader) {
+    task::Lazy<T, std::error_code> readBE(zero::meta::Trait<IReader> auto &reader) {
         std::array<std::byte, sizeof(T)> bytes{};
         Z_CO_EXPECT(co_await std::invoke(&IReader::readExactly, reader, bytes));
 
@@ -34,7 +34,7 @@ namespace asyncio::binary {
 
     template<typename T>
         requires (std::is_arithmetic_v<T> && sizeof(T) > 1)
-    task::Task<void, std::error_code> writeLE(zero::meta::Trait<IWriter> auto &writer, const T value) {
+    task::Lazy<void, std::error_code> writeLE(zero::meta::Trait<IWriter> auto &writer, const T value) {
         std::array<std::byte, sizeof(T)> bytes{};
 
         for (std::size_t i{0}; i < sizeof(T); ++i)
@@ -45,7 +45,7 @@ namespace asyncio::binary {
 
     template<typename T>
         requires (std::is_arithmetic_v<T> && sizeof(T) > 1)
-    task::Task<void, std::error_code> writeBE(zero::meta::Trait<IWriter> auto &writer, const T value) {
+    task::Lazy<void, std::error_code> writeBE(zero::meta::Trait<IWriter> auto &writer, const T value) {
         std::array<std::byte, sizeof(T)> bytes{};
 
         for (std::size_t i{0}; i < sizeof(T); ++i)
@@ -0,0 +1,379 @@
+#ifndef ASYNCIO_BROADCAST_CHANNEL_H
+#define ASYNCIO_BROADCAST_CHANNEL_H
+
+#include "channel.h"
+
+namespace asyncio {
+    /*
+     * Every element is stored once and shared by all receivers, each of which keeps its own cursor.
+     * The sender never waits, it overwrites the oldest element and receivers that had not read it yet are lagged.
+     */
+    template<typename T>
+    struct BroadcastChannelCore {
+        // Linked while a receiver waits for the next element, guarded by the mutex, the future is taken before linking.
+        struct Waiter {
+            Promise<void, std::error_code> promise;
+            Waiter *prev{};
+            Waiter *next{};
+            bool linked{false};
+        };
+
+        explicit BroadcastChannelCore(std::shared_ptr<EventLoop> e, const std::size_t capacity)
+            : eventLoop{std::move(e)}, slots((std::max)(capacity, std::size_t{1})) {
+        }
+
+        std::mutex mutex;
+        std::atomic<bool> closed;
+        std::shared_ptr<EventLoop> eventLoop;
+        std::vector<std::shared_ptr<const T>> slots;
+        // The sequence number of the next element.
+        std::uint64_t tail{0};
+        Waiter *waiters{};
+        Waiter *lastWaiter{};
+        std::atomic<std::size_t> senders;
+        std::atomic<std::size_t> receivers;
+
+        // Called with the mutex held.
+        [[nodiscard]] std::uint64_t oldest() const {
+            return tail > slots.size() ? tail - slots.size() : 0;
+        }
+
+        // Called with the mutex held.
+        void enqueue(Waiter &waiter) {
+            waiter.prev = lastWaiter;
+            waiter.next = nullptr;
+            waiter.linked = true;
+
+            if (lastWaiter)
+                lastWaiter->next = &waiter;
+            else
+                waiters = &waiter;
+
+            lastWaiter = &waiter;
+        }
+
+        // Called with the mutex held.
+        void unlink(Waiter &waiter) {
+            if (waiter.prev)
+                waiter.prev->next = waiter.next;
+            else
+                waiters = waiter.next;
+
+            if (waiter.next)
+                waiter.next->prev = waiter.prev;
+            else
+                lastWaiter = waiter.prev;
+
+            waiter.linked = false;
+        }
+
+        // Called with the mutex held, the detached waiters stay alive until they are resolved.
+        Waiter *detach() {
+            const auto head = std::exchange(waiters, nullptr);
+            lastWaiter = nullptr;
+
+            for (auto waiter = head; waiter; waiter = waiter->next)
+                waiter->linked = false;
+
+            return head;
+        }
+
+        // Called without the mutex, the promise is moved out since the waiter may go away as soon as it is resolved.
+        static void wake(Waiter *waiter) {
+            while (waiter) {
+                const auto next = waiter->next;
+                auto promise = std::move(waiter->promise);
+                promise.resolve();
+                waiter = next;
+            }
+        }
+
+        void close() {
+            Waiter *waiter;
+
+            {
+                const std::lock_guard guard{mutex};
+
+                if (closed)
+                    return;
+
+                closed = true;
+                waiter = detach();
+            }
+
+            wake(waiter);
+        }
+    };
+
+    Z_DEFINE_ERROR_CODE_EX(
+        BroadcastSendError,
+        "asyncio::BroadcastSender::send",
+        Disconnected, "Sending on a disconnected channel", Z_DEFAULT_ERROR_CONDITION,
+        NoReceivers, "Sending on a channel without receivers", Z_DEFAULT_ERROR_CONDITION
+    )
+
+    template<typename T>
+    class BroadcastReceiver;
+
+    template<typename T>
+    class BroadcastSender {
+    public:
+        explicit BroadcastSender(std::shared_ptr<BroadcastChannelCore<T>> core) : mCore{std::move(core)} {
+            ++mCore->senders;
+        }
+
+        BroadcastSender(const BroadcastSender &rhs) : mCore{rhs.mCore} {
+            ++mCore->senders;
+        }
+
+        BroadcastSender(BroadcastSender &&rhs) = default;
+
+        BroadcastSender &operator=(const BroadcastSender &rhs) {
+            mCore = rhs.mCore;
+            ++mCore->senders;
+            return *this;
+        }
+
+        BroadcastSender &operator=(BroadcastSender &&rhs) noexcept = default;
+
+        ~BroadcastSender() {
+            if (!mCore)
+                return;
+
+            if (--mCore->senders > 0)
+                return;
+
+            mCore->close();
+        }
+
+        /*
+         * A single allocation per element, however many receivers there are.
+         * Without receivers the element is dropped and `NoReceivers` is returned, the channel stays open for `subscribe`.
+         */
+        template<typename U = T>
+        std::expected<void, BroadcastSendError> send(U &&element) {
+            if (mCore->closed)
+                return std::unexpected{BroadcastSendError::Disconnected};
+
+            if (mCore->receivers == 0)
+                return std::unexpected{BroadcastSendError::NoReceivers};
+
+            auto value = std::make_shared<const T>(std::forward<U>(element));
+            typename BroadcastChannelCore<T>::Waiter *waiter;
+
+            {
+                const std::lock_guard guard{mCore->mutex};
+
+                if (mCore->closed)
+                    return std::unexpected{BroadcastSendError::Disconnected};
+
+                // The element being overwritten is released outside the lock.
+                std::swap(mCore->slots[mCore->tail % mCore->slots.size()], value);
+                ++mCore->tail;
+                waiter = mCore->detach();
+            }
+
+            mCore->wake(waiter);
+            return {};
+        }
+
+        // The new receiver only sees elements sent from now on.
+        BroadcastReceiver<T> subscribe() const {
+            return BroadcastReceiver<T>{mCore};
+        }
+
+        void close() {
+            mCore->close();
+        }
+
+        [[nodiscard]] std::size_t capacity() const {
+            return mCore->slots.size();
+        }
+
+        [[nodiscard]] std::size_t receivers() const {
+            return mCore->receivers;
+        }
+
+        [[nodiscard]] bool closed() const {
+            return mCore->closed;
+        }
+
+    private:
+        std::shared_ptr<BroadcastChannelCore<T>> mCore;
+    };
+
+    Z_DEFINE_ERROR_CODE_EX(
+        BroadcastTryReceiveError,
+        "asyncio::BroadcastReceiver::tryReceive",
+        Disconnected, "Receiving on an empty and disconnected channel", Z_DEFAULT_ERROR_CONDITION,
+        Empty, "Receiving on an empty channel", std::errc::operation_would_block,
+        Lagged, "Receiver lagged behind and missed elements", Z_DEFAULT_ERROR_CONDITION
+    )
+
+    Z_DEFINE_ERROR_CODE_EX(
+        BroadcastReceiveError,
+        "asyncio::BroadcastReceiver::receive",
+        Disconnected, "Receiving on an empty and disconnected channel", Z_DEFAULT_ERROR_CONDITION,
+        Lagged, "Receiver lagged behind and missed elements", Z_DEFAULT_ERROR_CONDITION,
+        Cancelled, "Receive operation was cancelled", std::errc::operation_canceled
+    )
+
+    template<typename T>
+    class BroadcastReceiver {
+    public:
+        explicit BroadcastReceiver(std::shared_ptr<BroadcastChannelCore<T>> core) : mCore{std::move(core)} {
+            const std::lock_guard guard{mCore->mutex};
+            mNext = mCore->tail;
+            ++mCore->receivers;
+        }
+
+        // The copy starts at the same position.
+        BroadcastReceiver(const BroadcastReceiver &rhs) : mCore{rhs.mCore}, mNext{rhs.mNext} {
+            ++mCore->receivers;
+        }
+
+        BroadcastReceiver(BroadcastReceiver &&rhs) = default;
+
+        BroadcastReceiver &operator=(const BroadcastReceiver &rhs) {
+            mCore = rhs.mCore;
+            mNext = rhs.mNext;
+            mLagged = 0;
+            ++mCore->receivers;
+            return *this;
+        }
+
+        BroadcastReceiver &operator=(BroadcastReceiver &&rhs) noexcept = default;
+
+        // Only the last sender closes the channel, so that it outlives moments without any receiver.
+        ~BroadcastReceiver() {
+            if (!mCore)
+                return;
+
+            --mCore->receivers;
+        }
+
+        /*
+         * A receiver that fell behind by more than the capacity gets `Lagged` once, with `lagged()` set to
+         * the number of elements it missed, and continues from the oldest element still available.
+         */
+        std::expected<std::shared_ptr<const T>, BroadcastTryReceiveError> tryReceive() {
+            const std::lock_guard guard{mCore->mutex};
+
+            if (skip())
+                return std::unexpected{BroadcastTryReceiveError::Lagged};
+
+            if (mNext < mCore->tail)
+                return mCore->slots[mNext++ % mCore->slots.size()];
+
+            return std::unexpected{
+                mCore->closed ? BroadcastTryReceiveError::Disconnected : BroadcastTryReceiveError::Empty
+            };
+        }
+
+        task::Task<std::shared_ptr<const T>, BroadcastReceiveError> receive() {
+            while (true) {
+                typename BroadcastChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
+                {
+                    const std::lock_guard guard{mCore->mutex};
+
+                    if (skip())
+                        co_return std::unexpected{BroadcastReceiveError::Lagged};
+
+                    if (mNext < mCore->tail)
+                        co_return mCore->slots[mNext++ % mCore->slots.size()];
+
+                    if (mCore->closed)
+                        co_return std::unexpected{BroadcastReceiveError::Disconnected};
+
+                    mCore->enqueue(waiter);
+                }
+
+                if (const auto result = co_await task::Cancellable{
+                    std::move(future),
+                    [&]() -> std::expected<void, std::error_code> {
+                        const std::lock_guard guard{mCore->mutex};
+
+                        if (!waiter.linked)
+                            return std::unexpected{task::Error::CancellationTooLate};
+
+                        mCore->unlink(waiter);
+                        waiter.promise.reject(task::Error::Cancelled);
+                        return {};
+                    }
+                }; !result) {
+                    assert(result.error() == std::errc::operation_canceled);
+                    co_return std::unexpected{BroadcastReceiveError::Cancelled};
+                }
+            }
+        }
+
+        // The number of elements missed by the last `Lagged` error.
+        [[nodiscard]] std::uint64_t lagged() const {
+            return mLagged;
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            const std::lock_guard guard{mCore->mutex};
+            return mCore->tail - (std::max)(mNext, mCore->oldest());
+        }
+
+        [[nodiscard]] std::size_t capacity() const {
+            return mCore->slots.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        void close() {
+            mCore->close();
+        }
+
+        [[nodiscard]] bool closed() const {
+            return mCore->closed;
+        }
+
+    private:
+        // Called with the mutex held.
+        bool skip() {
+            const auto oldest = mCore->oldest();
+
+            if (mNext >= oldest)
+                return false;
+
+            mLagged = oldest - mNext;
+            mNext = oldest;
+
+            return true;
+        }
+
+        std::shared_ptr<BroadcastChannelCore<T>> mCore;
+        std::uint64_t mNext{0};
+        std::uint64_t mLagged{0};
+    };
+
+    template<typename T>
+    using BroadcastChannel = std::pair<BroadcastSender<T>, BroadcastReceiver<T>>;
+
+    // Further receivers are created with `subscribe` or by copying one.
+    template<typename T>
+    BroadcastChannel<T> broadcastChannel(std::shared_ptr<EventLoop> eventLoop, const std::size_t capacity = 1) {
+        const auto core = std::make_shared<BroadcastChannelCore<T>>(std::move(eventLoop), capacity);
+        return {BroadcastSender<T>{core}, BroadcastReceiver<T>{core}};
+    }
+
+    template<typename T>
+    BroadcastChannel<T> broadcastChannel(const std::size_t capacity = 1) {
+        return broadcastChannel<T>(getEventLoop(), capacity);
+    }
+}
+
+Z_DECLARE_ERROR_CODES(
+    asyncio::BroadcastSendError,
+    asyncio::BroadcastTryReceiveError,
+    asyncio::BroadcastReceiveError
+)
+
+#endif //ASYNCIO_BROADCAST_CHANNEL_H
@@ -2,14 +2,30 @@
 #define ASYNCIO_CHANNEL_H
 
 #include "task.h"
+#include <mutex>
+#include <span>
 #include <chrono>
 #include <zero/atomic/circular_buffer.h>
 
 namespace asyncio {
     template<typename T>
     struct ChannelCore {
+        /*
+         * Lives in the frame of a waiting task or on the stack of a blocked thread, linked only while it waits.
+         * The future must be taken before the waiter is enqueued, since a wakeup moves the promise out.
+         */
+        struct Waiter {
+            Promise<void, std::error_code> promise;
+            Waiter *prev{};
+            Waiter *next{};
+            bool linked{false};
+        };
+
+        // The queue is guarded by the mutex, the number of waiters may be read without it.
         struct Context {
-            std::list<std::shared_ptr<Promise<void, std::error_code>>> pending;
+            Waiter *head{};
+            Waiter *tail{};
+            std::atomic<std::size_t> waiting{0};
             std::atomic<std::size_t> counter;
         };
 
@@ -17,57 +33,95 @@ namespace asyncio {
             : eventLoop{std::move(e)}, buffer{capacity + 1} {
         }
 
-        std::mutex mutex;
+        // Senders and receivers on different cores only touch each other's line when someone is waiting.
+        alignas(64) std::mutex mutex;
         std::atomic<bool> closed;
         std::shared_ptr<EventLoop> eventLoop;
         zero::atomic::CircularBuffer<T> buffer;
-        Context sender;
-        Context receiver;
+        alignas(64) Context sender;
+        alignas(64) Context receiver;
 
-        void notifySender() {
-            const std::lock_guard guard{mutex};
+        /*
+         * Called with the mutex held, the caller must look at the buffer again afterward,
+         * since a notifier that ran before the waiter became visible has skipped the queue.
+         */
+        void enqueue(Context &context, Waiter &waiter) {
+            waiter.prev = context.tail;
+            waiter.next = nullptr;
+            waiter.linked = true;
 
-            auto &pending = sender.pending;
+            if (context.tail)
+                context.tail->next = &waiter;
+            else
+                context.head = &waiter;
 
-            if (pending.empty())
-                return;
+            context.tail = &waiter;
+            context.waiting.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
 
-            for (const auto &promise: std::exchange(pending, {})) {
-                if (promise->isFulfilled())
-                    continue;
+        // Called with the mutex held.
+        void unlink(Context &context, Waiter &waiter) {
+            if (waiter.prev)
+                waiter.prev->next = waiter.next;
+            else
+                context.head = waiter.next;
 
-                promise->resolve();
-            }
+            if (waiter.next)
+                waiter.next->prev = waiter.prev;
+            else
+                context.tail = waiter.prev;
+
+            waiter.linked = false;
+            context.waiting.fetch_sub(1, std::memory_order_relaxed);
         }
 
-        void notifyReceiver() {
-            const std::lock_guard guard{mutex};
+        // Called with the mutex held, the promise is moved out since the waiter may go away as soon as it is resolved.
+        void wake(Context &context) {
+            const auto waiter = context.head;
+
+            if (!waiter)
+                return;
+
+            unlink(context, *waiter);
+            auto promise = std::move(waiter->promise);
+            promise.resolve();
+        }
 
-            auto &pending = receiver.pending;
+        // Every committed or released slot wakes a single waiter, the mutex is only taken when there is one.
+        void notify(Context &context, const std::size_t count) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
 
-            if (pending.empty())
+            if (context.waiting.load(std::memory_order_relaxed) == 0)
                 return;
 
-            for (const auto &promise: std::exchange(pending, {})) {
-                if (promise->isFulfilled())
-                    continue;
+            const std::lock_guard guard{mutex};
 
-                promise->resolve();
-            }
+            for (std::size_t i{0}; i < count && context.head; ++i)
+                wake(context);
+        }
+
+        void notifySender(const std::size_t count = 1) {
+            notify(sender, count);
+        }
+
+        void notifyReceiver(const std::size_t count = 1) {
+            notify(receiver, count);
         }
 
         void close() {
-            {
-                const std::lock_guard guard{mutex};
+            const std::lock_guard guard{mutex};
 
-                if (closed)
-                    return;
+            if (closed)
+                return;
 
-                closed = true;
-            }
+            closed = true;
+
+            while (sender.head)
+                wake(sender);
 
-            notifySender();
-            notifyReceiver();
+            while (receiver.head)
+                wake(receiver);
         }
     };
 
@@ -172,6 +226,9 @@ namespace asyncio {
                     return {};
                 }
 
+                typename ChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
                 mCore->mutex.lock();
 
                 if (mCore->closed) {
@@ -179,20 +236,26 @@ namespace asyncio {
                     return std::unexpected{SendSyncError::Disconnected};
                 }
 
+                mCore->enqueue(mCore->sender, waiter);
+
                 if (!mCore->buffer.full()) {
+                    mCore->unlink(mCore->sender, waiter);
                     mCore->mutex.unlock();
                     continue;
                 }
 
-                const auto promise = std::make_shared<Promise<void, std::error_code>>();
-
-                mCore->sender.pending.push_back(promise);
                 mCore->mutex.unlock();
 
-                if (const auto result = promise->getFuture().wait(timeout); !result) {
+                if (const auto result = future.wait(timeout); !result) {
                     assert(result.error() == std::errc::timed_out);
                     const std::lock_guard guard{mCore->mutex};
-                    mCore->sender.pending.remove(promise);
+
+                    // Woken right as it timed out, so the wakeup is handed on rather than lost.
+                    if (!waiter.linked)
+                        mCore->wake(mCore->sender);
+                    else
+                        mCore->unlink(mCore->sender, waiter);
+
                     return std::unexpected{SendSyncError::Timeout};
                 }
             }
@@ -213,6 +276,9 @@ namespace asyncio {
                     return {};
                 }
 
+                typename ChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
                 mCore->mutex.lock();
 
                 if (mCore->closed) {
@@ -220,20 +286,26 @@ namespace asyncio {
                     return std::unexpected{std::pair{std::move(element), SendSyncError::Disconnected}};
                 }
 
+                mCore->enqueue(mCore->sender, waiter);
+
                 if (!mCore->buffer.full()) {
+                    mCore->unlink(mCore->sender, waiter);
                     mCore->mutex.unlock();
                     continue;
                 }
 
-                const auto promise = std::make_shared<Promise<void, std::error_code>>();
-
-                mCore->sender.pending.push_back(promise);
                 mCore->mutex.unlock();
 
-                if (const auto result = promise->getFuture().wait(timeout); !result) {
+                if (const auto result = future.wait(timeout); !result) {
                     assert(result.error() == std::errc::timed_out);
                     const std::lock_guard guard{mCore->mutex};
-                    mCore->sender.pending.remove(promise);
+
+                    // Woken right as it timed out, so the wakeup is handed on rather than lost.
+                    if (!waiter.linked)
+                        mCore->wake(mCore->sender);
+                    else
+                        mCore->unlink(mCore->sender, waiter);
+
                     return std::unexpected{std::pair{std::move(element), SendSyncError::Timeout}};
                 }
             }
@@ -253,6 +325,9 @@ namespace asyncio {
                     co_return {};
                 }
 
+                typename ChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
                 mCore->mutex.lock();
 
                 if (mCore->closed) {
@@ -260,29 +335,30 @@ namespace asyncio {
                     co_return std::unexpected{SendError::Disconnected};
                 }
 
+                mCore->enqueue(mCore->sender, waiter);
+
                 if (!mCore->buffer.full()) {
+                    mCore->unlink(mCore->sender, waiter);
                     mCore->mutex.unlock();
                     continue;
                 }
 
-                const auto promise = std::make_shared<Promise<void, std::error_code>>();
-
-                mCore->sender.pending.push_back(promise);
                 mCore->mutex.unlock();
 
                 if (const auto result = co_await task::Cancellable{
-                    promise->getFuture(),
-                    [=]() -> std::expected<void, std::error_code> {
-                        if (promise->isFulfilled())
+                    std::move(future),
+                    [&]() -> std::expected<void, std::error_code> {
+                        const std::lock_guard guard{mCore->mutex};
+
+                        if (!waiter.linked)
                             return std::unexpected{task::Error::CancellationTooLate};
 
-                        promise->reject(task::Error::Cancelled);
+                        mCore->unlink(mCore->sender, waiter);
+                        waiter.promise.reject(task::Error::Cancelled);
                         return {};
                     }
                 }; !result) {
                     assert(result.error() == std::errc::operation_canceled);
-                    const std::lock_guard guard{mCore->mutex};
-                    mCore->sender.pending.remove(promise);
                     co_return std::unexpected{SendError::Cancelled};
                 }
             }
@@ -302,6 +378,9 @@ namespace asyncio {
                     co_return {};
                 }
 
+                typename ChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
                 mCore->mutex.lock();
 
                 if (mCore->closed) {
@@ -309,34 +388,56 @@ namespace asyncio {
                     co_return std::unexpected{std::pair{std::move(element), SendError::Disconnected}};
                 }
 
+                mCore->enqueue(mCore->sender, waiter);
+
                 if (!mCore->buffer.full()) {
+                    mCore->unlink(mCore->sender, waiter);
                     mCore->mutex.unlock();
                     continue;
                 }
 
-                const auto promise = std::make_shared<Promise<void, std::error_code>>();
-
-                mCore->sender.pending.push_back(promise);
                 mCore->mutex.unlock();
 
                 if (const auto result = co_await task::Cancellable{
-                    promise->getFuture(),
-                    [=]() -> std::expected<void, std::error_code> {
-                        if (promise->isFulfilled())
+                    std::move(future),
+                    [&]() -> std::expected<void, std::error_code> {
+                        const std::lock_guard guard{mCore->mutex};
+
+                        if (!waiter.linked)
                             return std::unexpected{task::Error::CancellationTooLate};
 
-                        promise->reject(task::Error::Cancelled);
+                        mCore->unlink(mCore->sender, waiter);
+                        waiter.promise.reject(task::Error::Cancelled);
                         return {};
                     }
                 }; !result) {
                     assert(result.error() == std::errc::operation_canceled);
-                    const std::lock_guard guard{mCore->mutex};
-                    mCore->sender.pending.remove(promise);
                     co_return std::unexpected{std::pair{std::move(element), SendError::Cancelled}};
                 }
             }
         }
 
+        // Moves elements into as many free slots as there are, and only waits while none is free.
+        task::Task<std::size_t, SendError> sendMany(const std::span<T> elements) {
+            if (elements.empty())
+                co_return 0;
+
+            if (mCore->closed)
+                co_return std::unexpected{SendError::Disconnected};
+
+            if (const auto count = fill(elements); count > 0)
+                co_return count;
+
+            // The element is handed back on failure, so that the caller still owns everything that was not sent.
+            if (auto result = co_await sendEx(std::move(elements.front())); !result) {
+                auto &[element, error] = result.error();
+                elements.front() = std::move(element);
+                co_return std::unexpected{error};
+            }
+
+            co_return 1 + fill(elements.subspan(1));
+        }
+
         void close() {
             mCore->close();
         }
@@ -362,6 +463,26 @@ namespace asyncio {
         }
 
     private:
+        // Receivers are woken once for the whole batch.
+        std::size_t fill(const std::span<T> elements) {
+            std::size_t count{0};
+
+            while (count < elements.size()) {
+                const auto index = mCore->buffer.reserve();
+
+                if (!index)
+                    break;
+
+                mCore->buffer[*index] = std::move(elements[count++]);
+                mCore->buffer.commit(*index);
+            }
+
+            if (count > 0)
+                mCore->notifyReceiver(count);
+
+            return count;
+        }
+
         std::shared_ptr<ChannelCore<T>> mCore;
     };
 
@@ -443,27 +564,36 @@ namespace asyncio {
                     return element;
                 }
 
+                typename ChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
                 mCore->mutex.lock();
+                mCore->enqueue(mCore->receiver, waiter);
 
                 if (!mCore->buffer.empty()) {
+                    mCore->unlink(mCore->receiver, waiter);
                     mCore->mutex.unlock();
                     continue;
                 }
 
                 if (mCore->closed) {
+                    mCore->unlink(mCore->receiver, waiter);
                     mCore->mutex.unlock();
                     return std::unexpected{ReceiveSyncError::Disconnected};
                 }
 
-                const auto promise = std::make_shared<Promise<void, std::error_code>>();
-
-                mCore->receiver.pending.push_back(promise);
                 mCore->mutex.unlock();
 
-                if (const auto result = promise->getFuture().wait(timeout); !result) {
+                if (const auto result = future.wait(timeout); !result) {
                     assert(result.error() == std::errc::timed_out);
                     const std::lock_guard guard{mCore->mutex};
-                    mCore->receiver.pending.remove(promise);
+
+                    // Woken right as it timed out, so the wakeup is handed on rather than lost.
+                    if (!waiter.linked)
+                        mCore->wake(mCore->receiver);
+                    else
+                        mCore->unlink(mCore->receiver, waiter);
+
                     return std::unexpected{ReceiveSyncError::Timeout};
                 }
             }
@@ -480,41 +610,87 @@ namespace asyncio {
                     co_return element;
                 }
 
+                typename ChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
                 mCore->mutex.lock();
+                mCore->enqueue(mCore->receiver, waiter);
 
                 if (!mCore->buffer.empty()) {
+                    mCore->unlink(mCore->receiver, waiter);
                     mCore->mutex.unlock();
                     continue;
                 }
 
                 if (mCore->closed) {
+                    mCore->unlink(mCore->receiver, waiter);
                     mCore->mutex.unlock();
                     co_return std::unexpected{ReceiveError::Disconnected};
                 }
 
-                const auto promise = std::make_shared<Promise<void, std::error_code>>();
-
-                mCore->receiver.pending.push_back(promise);
                 mCore->mutex.unlock();
 
                 if (const auto result = co_await task::Cancellable{
-                    promise->getFuture(),
-                    [=]() -> std::expected<void, std::error_code> {
-                        if (promise->isFulfilled())
+                    std::move(future),
+                    [&]() -> std::expected<void, std::error_code> {
+                        const std::lock_guard guard{mCore->mutex};
+
+                        if (!waiter.linked)
                             return std::unexpected{task::Error::CancellationTooLate};
 
-                        promise->reject(task::Error::Cancelled);
+                        mCore->unlink(mCore->receiver, waiter);
+                        waiter.promise.reject(task::Error::Cancelled);
                         return {};
                     }
                 }; !result) {
                     assert(result.error() == std::errc::operation_canceled);
-                    const std::lock_guard guard{mCore->mutex};
-                    mCore->receiver.pending.remove(promise);
                     co_return std::unexpected{ReceiveError::Cancelled};
                 }
             }
         }
 
+        // Waits for at least one element, then drains as many as are available, returning how many were received.
+        task::Task<std::size_t, ReceiveError> receiveMany(const std::span<T> elements) {
+            if (elements.empty())
+                co_return 0;
+
+            if (const auto count = drain(elements.size(), [&, it = elements.begin()](T element) mutable {
+                *it++ = std::move(element);
+            }); count > 0)
+                co_return count;
+
+            auto element = co_await receive();
+            Z_CO_EXPECT(element);
+
+            elements.front() = *std::move(element);
+
+            co_return 1 + drain(elements.size() - 1, [&, it = elements.begin() + 1](T e) mutable {
+                *it++ = std::move(e);
+            });
+        }
+
+        task::Task<std::vector<T>, ReceiveError> receiveMany(const std::size_t max) {
+            std::vector<T> elements;
+
+            if (max == 0)
+                co_return elements;
+
+            const auto push = [&](T element) {
+                elements.push_back(std::move(element));
+            };
+
+            if (drain(max, push) > 0)
+                co_return elements;
+
+            auto element = co_await receive();
+            Z_CO_EXPECT(element);
+
+            elements.push_back(*std::move(element));
+            drain(max - 1, push);
+
+            co_return elements;
+        }
+
         [[nodiscard]] std::size_t size() const {
             return mCore->buffer.size();
         }
@@ -536,6 +712,28 @@ namespace asyncio {
         }
 
     private:
+        // Senders are woken once for the whole batch.
+        template<typename F>
+        std::size_t drain(const std::size_t max, F &&f) {
+            std::size_t count{0};
+
+            while (count < max) {
+                const auto index = mCore->buffer.acquire();
+
+                if (!index)
+                    break;
+
+                f(std::move(mCore->buffer[*index]));
+                mCore->buffer.release(*index);
+                ++count;
+            }
+
+            if (count > 0)
+                mCore->notifySender(count);
+
+            return count;
+        }
+
         std::shared_ptr<ChannelCore<T>> mCore;
     };
 
@@ -52,6 +52,20 @@ namespace asyncio::error {
             co_return *std::move(result);
     }
 
+    // A lazy task stays lazy, it only starts once the guard is awaited.
+    template<typename T, std::convertible_to<std::error_code> E>
+    task::Lazy<T> guard(task::Lazy<T, E> lazy) {
+        auto result = co_await std::move(lazy);
+
+        if (!result)
+            throw co_await StacktraceError<std::system_error>::make(result.error());
+
+        if constexpr (std::is_void_v<T>)
+            co_return;
+        else
+            co_return *std::move(result);
+    }
+
     template<typename T>
     task::Task<std::expected<T, std::exception_ptr>>
     capture(task::Task<T> task) {
@@ -68,6 +82,23 @@ namespace asyncio::error {
             co_return std::unexpected{std::current_exception()};
         }
     }
+
+    template<typename T>
+    task::Lazy<std::expected<T, std::exception_ptr>>
+    capture(task::Lazy<T> lazy) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(lazy);
+                co_return {};
+            }
+            else {
+                co_return co_await std::move(lazy);
+            }
+        }
+        catch (const std::exception &) {
+            co_return std::unexpected{std::current_exception()};
+        }
+    }
 }
 
 #endif //ASYNCIO_ERROR_H
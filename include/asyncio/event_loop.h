@@ -3,36 +3,198 @@
 
 #include "uv.h"
 #include "concepts.h"
+#include "histogram.h"
+#include <array>
+#include <utility>
+#include <deque>
 #include <mutex>
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <optional>
 #include <cassert>
+#include <source_location>
 #include <zero/async/promise.h>
 
 namespace asyncio {
+    namespace task {
+        struct Frame;
+    }
+
+    class TimerWheel;
+    class SlowAwaitDetector;
+
+    enum class Priority {
+        High,
+        Normal,
+        Background
+    };
+
+    // Durations are in microseconds.
+    struct EventLoopMetrics {
+        std::uint64_t iterations;
+        // From one poll to the next.
+        HistogramSnapshot iteration;
+        // From `post` to the callable being run.
+        HistogramSnapshot lag;
+        // Callables waiting at the start of every drain.
+        HistogramSnapshot depth;
+        std::size_t queued;
+        std::chrono::nanoseconds elapsed;
+        // Blocked in poll.
+        std::chrono::nanoseconds idle;
+        std::size_t activeHandles;
+        std::size_t activeRequests;
+
+        // The share of the elapsed time spent running callbacks rather than waiting for I/O.
+        [[nodiscard]] double utilisation() const;
+    };
+
+    // Published by the event loop thread while it is watched, read by the watchdog thread.
+    struct Heartbeat {
+        std::atomic<bool> watched{false};
+        // Off while the event loop is blocked in poll or not running at all, which never counts as a stall.
+        std::atomic<bool> busy{false};
+        // Bumped whenever the event loop enters or leaves poll.
+        std::atomic<std::uint64_t> beats{0};
+        // The task resumed last, cleared when its frame goes away, only published while watched.
+        std::atomic<const task::Frame *> frame{nullptr};
+        // Bumped whenever `frame` changes, so that a backtrace read meanwhile is dropped.
+        std::atomic<std::uint64_t> steps{0};
+    };
+
+    // Every frame living on an event loop, linked through the frames themselves and only touched by its thread.
+    struct FrameRegistry {
+        task::Frame *head{};
+    };
+
     class EventLoop final : public zero::async::promise::IExecutor {
+        // The time of posting is only taken when metrics are enabled.
+        struct Callable {
+            std::function<void()> function;
+            std::chrono::steady_clock::time_point posted;
+        };
+
+        struct Node {
+            std::atomic<Node *> next;
+            Callable callable;
+            Priority priority;
+        };
+
+        // Only allocated when metrics are enabled, updated by the event loop thread and read from any.
+        struct Instrumentation {
+            uv::Handle<uv_prepare_t> prepare;
+            std::uint64_t previous{0};
+            std::atomic<std::uint64_t> started{0};
+            std::atomic<std::uint64_t> iterations{0};
+            std::atomic<std::size_t> queued{0};
+            std::atomic<std::size_t> activeHandles{0};
+            std::atomic<std::size_t> activeRequests{0};
+            Histogram iteration;
+            Histogram lag;
+            Histogram depth;
+        };
+
+        // Loop-local lanes for callables posted from the event loop thread itself, no atomics or wakeups needed.
+        struct ReadyQueue {
+            [[nodiscard]] bool empty() const;
+            void wake();
+            void push(Callable callable, Priority priority);
+            void defer(Callable callable);
+            void run(Callable callable, Priority lane);
+            // Only the drain right after polling runs the deferred callables.
+            void drain(bool polled);
+
+            uv::Handle<uv_check_t> check;
+            uv::Handle<uv_idle_t> idle;
+            std::array<std::deque<Callable>, 3> lanes;
+            std::deque<std::pair<Callable, Priority>> deferred;
+            Priority priority{Priority::Normal};
+            Instrumentation *instrumentation{};
+        };
+
+        // Intrusive MPSC queue, any thread may push, only the event loop thread pops.
         struct TaskQueue {
+            explicit TaskQueue(uv::Handle<uv_async_t> handle);
+            ~TaskQueue();
+
+            void push(Node *node);
+            Node *pop();
+
             uv::Handle<uv_async_t> async;
-            std::mutex mutex;
-            std::queue<std::function<void()>> queue;
+            ReadyQueue *readyQueue;
+            std::atomic<bool> pending;
+            std::atomic<Node *> head;
+            Node *tail;
+            Node stub;
+        };
+
+        // Only created once the event loop is watched.
+        struct Pulse {
+            uv::Handle<uv_prepare_t> prepare;
+            uv::Handle<uv_check_t> check;
+        };
+
+        // Bound to a single lane, so that futures resumed via it keep the priority of the awaiting task.
+        struct Lane final : IExecutor {
+            Lane(EventLoop *loop, const Priority p) : eventLoop{loop}, priority{p} {
+            }
+
+            void post(std::function<void()> f) override {
+                eventLoop->post(std::move(f), priority);
+            }
+
+            EventLoop *eventLoop;
+            Priority priority;
         };
 
     public:
         explicit EventLoop(
             std::unique_ptr<uv_loop_t, void (*)(uv_loop_t *)> loop,
-            std::unique_ptr<TaskQueue> taskQueue
+            std::unique_ptr<TaskQueue> taskQueue,
+            std::unique_ptr<ReadyQueue> readyQueue,
+            std::unique_ptr<TimerWheel> timerWheel,
+            std::unique_ptr<Instrumentation> instrumentation
         );
 
-        EventLoop(EventLoop &&rhs) = default;
-        EventLoop &operator=(EventLoop &&rhs) noexcept = default;
+        EventLoop(EventLoop &&rhs) noexcept;
+        EventLoop &operator=(EventLoop &&rhs) noexcept;
 
         ~EventLoop() override;
 
-        static EventLoop make();
+        // Timers are rounded up to multiples of the resolution.
+        static EventLoop make(
+            std::chrono::milliseconds timerResolution = std::chrono::milliseconds{1},
+            bool metrics = false
+        );
 
         uv_loop_t *raw();
         [[nodiscard]] const uv_loop_t *raw() const;
 
+        // Without a priority, callables go to the normal lane.
         void post(std::function<void()> f) override;
+        void post(std::function<void()> f, Priority priority);
+
+        // Runs the callable in the drain right after the event loop has next polled for I/O.
+        void defer(std::function<void()> f);
+
+        // The lane being drained, or normal outside of draining.
+        [[nodiscard]] Priority priority() const;
+        IExecutor *lane(Priority priority);
+
+        TimerWheel &timerWheel();
+
+        // A cheap snapshot that may be taken from any thread, empty unless the event loop was made with metrics.
+        [[nodiscard]] std::optional<EventLoopMetrics> metrics() const;
+
+        [[nodiscard]] Heartbeat &heartbeat() const;
+        [[nodiscard]] FrameRegistry &registry() const;
+        // Only touched by the event loop thread.
+        [[nodiscard]] SlowAwaitDetector *detector() const;
+        void setDetector(SlowAwaitDetector *detector);
+        // May be called from any thread, the event loop starts publishing its heartbeat on its next turn.
+        std::shared_ptr<Heartbeat> watch();
 
         void stop();
         void run();
@@ -40,8 +202,23 @@ namespace asyncio {
     private:
         std::unique_ptr<uv_loop_t, void (*)(uv_loop_t *)> mLoop;
         std::unique_ptr<TaskQueue> mTaskQueue;
+        std::unique_ptr<ReadyQueue> mReadyQueue;
+        std::unique_ptr<TimerWheel> mTimerWheel;
+        std::unique_ptr<Instrumentation> mInstrumentation;
+        std::shared_ptr<Heartbeat> mHeartbeat;
+        std::unique_ptr<Pulse> mPulse;
+        std::unique_ptr<FrameRegistry> mRegistry;
+        SlowAwaitDetector *mDetector{};
+        std::array<Lane, 3> mLanes;
     };
 
+    /*
+     * Every await that completes synchronously consumes the cooperative budget of the running event loop,
+     * once it is exhausted, the awaiting coroutine yields so that timers and I/O are not starved.
+     * The budget is refilled for each callable drained from the run queue.
+     */
+    bool consumeBudget();
+
     std::shared_ptr<EventLoop> getEventLoop();
     void setEventLoop(const std::weak_ptr<EventLoop> &eventLoop);
 
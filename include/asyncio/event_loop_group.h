@@ -0,0 +1,227 @@
+#ifndef ASYNCIO_EVENT_LOOP_GROUP_H
+#define ASYNCIO_EVENT_LOOP_GROUP_H
+
+#include "task.h"
+#include <thread>
+
+namespace asyncio {
+    class EventLoopGroup {
+    public:
+        // Work-stealing state of an event loop, only defined in the implementation.
+        struct Worker;
+
+        EventLoopGroup(std::vector<std::shared_ptr<EventLoop>> eventLoops, bool pinned);
+        EventLoopGroup(EventLoopGroup &&rhs) noexcept;
+        ~EventLoopGroup();
+
+        static EventLoopGroup make(std::size_t size = std::thread::hardware_concurrency(), bool pinned = false);
+        static std::expected<void, std::error_code> pin(std::thread &thread, std::size_t core);
+
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] const std::shared_ptr<EventLoop> &at(std::size_t index) const;
+
+        // Runs `f(index)` on every event loop, each in its own thread, until all of them are completed.
+        template<typename F>
+            requires (
+                std::invocable<F &, std::size_t> &&
+                zero::meta::Specialization<std::invoke_result_t<F &, std::size_t>, task::Task>
+            )
+        std::vector<
+            std::expected<
+                typename std::invoke_result_t<F &, std::size_t>::value_type,
+                typename std::invoke_result_t<F &, std::size_t>::error_type
+            >
+        >
+        run(F f) {
+            using T = typename std::invoke_result_t<F &, std::size_t>::value_type;
+            using E = typename std::invoke_result_t<F &, std::size_t>::error_type;
+
+            std::vector<std::optional<std::expected<T, E>>> results(mEventLoops.size());
+            std::vector<std::thread> threads;
+
+            for (std::size_t i{0}; i < mEventLoops.size(); ++i) {
+                threads.emplace_back([&, i] {
+                    work(i, [&] {
+                        results[i].emplace(asyncio::run(mEventLoops[i], [&] {
+                            return std::invoke(f, i);
+                        }));
+                    });
+                });
+
+                if (mPinned)
+                    std::ignore = pin(threads.back(), i % (std::max)(std::thread::hardware_concurrency(), 1u));
+            }
+
+            for (auto &thread: threads)
+                thread.join();
+
+            return results
+                | std::views::transform([](auto &result) {
+                    return *std::move(result);
+                })
+                | std::ranges::to<std::vector>();
+        }
+
+        /*
+         * Spawns a task that may be moved between the event loops of the group while it runs `group.run`.
+         * At every `co_await task::migratable`, the task is queued on the local deque of its event loop,
+         * idle event loops steal from the deques of their peers.
+         */
+        template<Invocable F>
+            requires zero::meta::Specialization<std::invoke_result_t<F>, task::Task>
+        std::invoke_result_t<F> submit(F f) {
+            using T = typename std::invoke_result_t<F>::value_type;
+            using E = typename std::invoke_result_t<F>::error_type;
+
+            struct Context : std::enable_shared_from_this<Context> {
+                explicit Context(F fn) : function{std::move(fn)} {
+                }
+
+                // The reference count of a frame is not atomic, the last one is always dropped by its event loop.
+                ~Context() {
+                    if (!task || migration.eventLoop == getEventLoop())
+                        return;
+
+                    migration.eventLoop->post([t = std::make_shared<task::Task<T, E>>(*std::move(task))] {
+                    });
+                }
+
+                // Cancellation is forwarded until it reaches the event loop that owns the task.
+                void cancel() {
+                    const std::lock_guard guard{migration.mutex};
+
+                    if (migration.eventLoop != getEventLoop()) {
+                        migration.eventLoop->post([self = this->shared_from_this()] {
+                            self->cancel();
+                        });
+                        return;
+                    }
+
+                    if (task)
+                        std::ignore = task->cancel();
+                }
+
+                F function;
+                Promise<T, E> promise;
+                task::Migration migration;
+                std::optional<task::Task<T, E>> task;
+            };
+
+            const auto context = std::make_shared<Context>(std::move(f));
+            const auto eventLoop = pick();
+
+            context->migration.eventLoop = eventLoop;
+
+            eventLoop->post([=] {
+                Promise<void> started;
+
+                // The root frame must be marked before the body runs, so it waits for one turn of the event loop.
+                auto task = [](const auto ctx, Future<void> future) -> task::Task<T, E> {
+                    co_await std::move(future);
+                    co_return co_await std::invoke(std::move(ctx->function));
+                }(context, started.getFuture());
+
+                task.mFrame->migration = &context->migration;
+
+                context->task.emplace(std::move(task));
+                context->task->addCallback([=] {
+                    auto result = std::exchange(context->task, std::nullopt)->future().result();
+
+                    if (!result) {
+                        context->promise.reject(std::move(result).error());
+                        return;
+                    }
+
+                    if constexpr (std::is_void_v<T>)
+                        context->promise.resolve();
+                    else
+                        context->promise.resolve(*std::move(result));
+                });
+
+                started.resolve();
+            });
+
+            co_return co_await task::Cancellable{
+                context->promise.getFuture(),
+                [=]() -> std::expected<void, std::error_code> {
+                    context->cancel();
+                    return {};
+                }
+            };
+        }
+
+    private:
+        void work(std::size_t index, const std::function<void()> &function);
+        std::shared_ptr<EventLoop> pick() const;
+
+        bool mPinned;
+        std::vector<std::shared_ptr<EventLoop>> mEventLoops;
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+    };
+
+    // Starts the task on the given event loop, the result is marshalled back to the calling event loop.
+    template<Invocable F>
+        requires zero::meta::Specialization<std::invoke_result_t<F>, task::Task>
+    std::invoke_result_t<F> spawnOn(std::shared_ptr<EventLoop> eventLoop, F f) {
+        using T = typename std::invoke_result_t<F>::value_type;
+        using E = typename std::invoke_result_t<F>::error_type;
+
+        if (eventLoop == getEventLoop())
+            co_return co_await std::invoke(std::move(f));
+
+        // The task is created, cancelled and released only on the target event loop.
+        struct Context {
+            // The reference count of a frame is not atomic, a task left over is handed back to its event loop.
+            ~Context() {
+                if (!task || eventLoop == getEventLoop())
+                    return;
+
+                eventLoop->post([t = std::make_shared<task::Task<T, E>>(*std::move(task))] {
+                });
+            }
+
+            std::shared_ptr<EventLoop> eventLoop;
+            F function;
+            Promise<T, E> promise;
+            std::optional<task::Task<T, E>> task;
+        };
+
+        const auto context = std::make_shared<Context>(eventLoop, std::move(f));
+
+        eventLoop->post([=] {
+            context->task.emplace(std::invoke(std::move(context->function)));
+            context->task->addCallback([=] {
+                auto result = std::exchange(context->task, std::nullopt)->future().result();
+
+                if (!result) {
+                    context->promise.reject(std::move(result).error());
+                    return;
+                }
+
+                if constexpr (std::is_void_v<T>)
+                    context->promise.resolve();
+                else
+                    context->promise.resolve(*std::move(result));
+            });
+        });
+
+        co_return co_await task::Cancellable{
+            context->promise.getFuture(),
+            [=]() -> std::expected<void, std::error_code> {
+                eventLoop->post([=] {
+                    if (context->task)
+                        std::ignore = context->task->cancel();
+                });
+                return {};
+            }
+        };
+    }
+
+    template<Invocable F>
+        requires zero::meta::Specialization<std::invoke_result_t<F>, task::Task>
+    std::invoke_result_t<F> spawnOn(const EventLoopGroup &group, const std::size_t index, F f) {
+        return spawnOn(group.at(index), std::move(f));
+    }
+}
+
+#endif //ASYNCIO_EVENT_LOOP_GROUP_H
@@ -0,0 +1,37 @@
+#ifndef ASYNCIO_HISTOGRAM_H
+#define ASYNCIO_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace asyncio {
+    // Base-2 buckets, bucket `i` counts the values in [2^(i-1), 2^i), bucket 0 counts zeros.
+    struct HistogramSnapshot {
+        static constexpr std::size_t Buckets = 64;
+
+        std::array<std::uint64_t, Buckets> buckets{};
+        std::uint64_t count{};
+        std::uint64_t sum{};
+        std::uint64_t max{};
+
+        [[nodiscard]] double mean() const;
+        // The upper bound of the bucket holding the quantile, clamped to the maximum.
+        [[nodiscard]] std::uint64_t quantile(double q) const;
+    };
+
+    // Recorded by a single thread without read-modify-write operations, and read from any thread.
+    class Histogram {
+    public:
+        void record(std::uint64_t value);
+        [[nodiscard]] HistogramSnapshot snapshot() const;
+
+    private:
+        std::array<std::atomic<std::uint64_t>, HistogramSnapshot::Buckets> mBuckets{};
+        std::atomic<std::uint64_t> mCount{0};
+        std::atomic<std::uint64_t> mSum{0};
+        std::atomic<std::uint64_t> mMax{0};
+    };
+}
+
+#endif //ASYNCIO_HISTOGRAM_H
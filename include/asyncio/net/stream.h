@@ -54,12 +54,18 @@ namespace asyncio::net {
         explicit TCPListener(Listener listener);
 
     private:
-        static std::expected<TCPListener, std::error_code> listen(const SocketAddress &address);
+        static std::expected<TCPListener, std::error_code> listen(const SocketAddress &address, bool reusePort);
 
     public:
         static std::expected<TCPListener, std::error_code> listen(const std::string &ip, std::uint16_t port);
         static std::expected<TCPListener, std::error_code> listen(const IPAddress &address);
 
+        // With `SO_REUSEPORT`, every event loop can listen on the same address and the kernel balances accepts.
+        static std::expected<TCPListener, std::error_code>
+        listen(const std::string &ip, std::uint16_t port, bool reusePort);
+
+        static std::expected<TCPListener, std::error_code> listen(const IPAddress &address, bool reusePort);
+
         [[nodiscard]] FileDescriptor fd() const override;
         [[nodiscard]] std::expected<IPAddress, std::error_code> address() const;
 
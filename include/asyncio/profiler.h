@@ -0,0 +1,38 @@
+#ifndef ASYNCIO_PROFILER_H
+#define ASYNCIO_PROFILER_H
+
+#include "time.h"
+#include <map>
+
+namespace asyncio {
+    /*
+     * Samples the async stacks of the tasks on the event loop of the calling thread, at a fixed interval.
+     * Only tasks that are suspended can be seen, so it shows where time is spent waiting rather than running.
+     * Every frame is registered with its event loop anyway, so the tasks created before profiling starts are seen too.
+     */
+    class Profiler {
+    public:
+        explicit Profiler(std::chrono::milliseconds interval = std::chrono::milliseconds{10});
+        Profiler(const Profiler &) = delete;
+        Profiler &operator=(const Profiler &) = delete;
+        ~Profiler();
+
+        [[nodiscard]] std::size_t samples() const;
+        // One line per stack, the await sites from the root down separated by semicolons, then the number of hits.
+        [[nodiscard]] std::string folded() const;
+        // The innermost await sites, by number of hits in descending order.
+        [[nodiscard]] std::vector<std::pair<std::string, std::size_t>> sites() const;
+
+    private:
+        void sample();
+
+        std::shared_ptr<EventLoop> mEventLoop;
+        std::chrono::milliseconds mInterval;
+        std::size_t mSamples{0};
+        std::map<std::string, std::size_t> mStacks;
+        std::map<std::string, std::size_t> mSites;
+        TimerWheel::Entry mEntry;
+    };
+}
+
+#endif //ASYNCIO_PROFILER_H
@@ -0,0 +1,40 @@
+#ifndef ASYNCIO_SLOW_AWAIT_H
+#define ASYNCIO_SLOW_AWAIT_H
+
+#include "task.h"
+
+namespace asyncio {
+    /*
+     * Reports the awaits of tasks on the event loop of the calling thread that took longer than the threshold.
+     * While it is attached, every await takes the time when it starts, and compares it when the task resumes.
+     */
+    class SlowAwaitDetector {
+    public:
+        struct SlowAwait {
+            std::chrono::nanoseconds duration;
+            std::source_location location;
+            // The awaits of the tasks waiting for it, innermost first.
+            std::vector<std::source_location> backtrace;
+
+            [[nodiscard]] std::string trace() const;
+        };
+
+        // Called on the event loop thread, right before the task resumes.
+        using Sink = std::function<void(const SlowAwait &)>;
+
+        explicit SlowAwaitDetector(std::chrono::nanoseconds threshold, Sink sink = nullptr);
+        SlowAwaitDetector(const SlowAwaitDetector &) = delete;
+        SlowAwaitDetector &operator=(const SlowAwaitDetector &) = delete;
+        ~SlowAwaitDetector();
+
+        void check(const task::Frame &frame, std::chrono::nanoseconds duration);
+
+    private:
+        std::shared_ptr<EventLoop> mEventLoop;
+        SlowAwaitDetector *mPrevious;
+        std::chrono::nanoseconds mThreshold;
+        Sink mSink;
+    };
+}
+
+#endif //ASYNCIO_SLOW_AWAIT_H
@@ -0,0 +1,393 @@
+#ifndef ASYNCIO_SPSC_CHANNEL_H
+#define ASYNCIO_SPSC_CHANNEL_H
+
+#include "channel.h"
+
+namespace asyncio {
+    /*
+     * A ring with exactly one producer and one consumer, each side owns its index and only reads the other one
+     * when its cached copy says the ring is full or empty, so neither side ever takes a lock or retries.
+     */
+    template<typename T>
+    struct SPSCChannelCore {
+        // At most one per side, parked in the frame of the waiting task or on the stack of the blocked thread.
+        struct Waiter {
+            Promise<void, std::error_code> promise;
+        };
+
+        explicit SPSCChannelCore(std::shared_ptr<EventLoop> e, const std::size_t capacity)
+            : eventLoop{std::move(e)}, slots(capacity + 1) {
+        }
+
+        std::atomic<bool> closed;
+        std::shared_ptr<EventLoop> eventLoop;
+        std::vector<T> slots;
+        // Written by the sender.
+        alignas(64) std::atomic<std::size_t> tail{0};
+        std::size_t headCache{0};
+        std::atomic<Waiter *> sender{nullptr};
+        // Written by the receiver.
+        alignas(64) std::atomic<std::size_t> head{0};
+        std::size_t tailCache{0};
+        std::atomic<Waiter *> receiver{nullptr};
+
+        [[nodiscard]] std::size_t next(const std::size_t index) const {
+            return index + 1 == slots.size() ? 0 : index + 1;
+        }
+
+        // Only called by the sender.
+        std::optional<std::size_t> reserve() {
+            const auto index = tail.load(std::memory_order_relaxed);
+
+            if (next(index) == headCache) {
+                headCache = head.load(std::memory_order_acquire);
+
+                if (next(index) == headCache)
+                    return std::nullopt;
+            }
+
+            return index;
+        }
+
+        void commit(const std::size_t index) {
+            tail.store(next(index), std::memory_order_release);
+        }
+
+        // Only called by the receiver.
+        std::optional<std::size_t> acquire() {
+            const auto index = head.load(std::memory_order_relaxed);
+
+            if (index == tailCache) {
+                tailCache = tail.load(std::memory_order_acquire);
+
+                if (index == tailCache)
+                    return std::nullopt;
+            }
+
+            return index;
+        }
+
+        void release(const std::size_t index) {
+            head.store(next(index), std::memory_order_release);
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            const auto h = head.load(std::memory_order_acquire);
+            const auto t = tail.load(std::memory_order_acquire);
+            return t >= h ? t - h : t + slots.size() - h;
+        }
+
+        /*
+         * The waiting side publishes itself and then looks at the ring again, while the notifying side updates
+         * the ring and then looks for a waiter, the fences make sure that at least one of them sees the other.
+         */
+        static void park(std::atomic<Waiter *> &slot, Waiter &waiter) {
+            slot.store(&waiter, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        // Fails once the notifier has claimed the waiter, which is then about to be resolved.
+        static bool unpark(std::atomic<Waiter *> &slot, Waiter &waiter) {
+            auto expected = &waiter;
+            return slot.compare_exchange_strong(expected, nullptr);
+        }
+
+        static void notify(std::atomic<Waiter *> &slot) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (!slot.load(std::memory_order_relaxed))
+                return;
+
+            const auto waiter = slot.exchange(nullptr);
+
+            if (!waiter)
+                return;
+
+            auto promise = std::move(waiter->promise);
+            promise.resolve();
+        }
+
+        void close() {
+            if (closed.exchange(true))
+                return;
+
+            notify(sender);
+            notify(receiver);
+        }
+    };
+
+    template<typename T>
+    class SPSCSender {
+    public:
+        explicit SPSCSender(std::shared_ptr<SPSCChannelCore<T>> core) : mCore{std::move(core)} {
+        }
+
+        SPSCSender(SPSCSender &&rhs) = default;
+        SPSCSender &operator=(SPSCSender &&rhs) noexcept = default;
+
+        ~SPSCSender() {
+            if (!mCore)
+                return;
+
+            mCore->close();
+        }
+
+        template<typename U = T>
+        std::expected<void, TrySendError> trySend(U &&element) {
+            if (mCore->closed)
+                return std::unexpected{TrySendError::Disconnected};
+
+            const auto index = mCore->reserve();
+
+            if (!index)
+                return std::unexpected{TrySendError::Full};
+
+            mCore->slots[*index] = std::forward<U>(element);
+            mCore->commit(*index);
+            mCore->notify(mCore->receiver);
+
+            return {};
+        }
+
+        template<typename U = T>
+        std::expected<void, SendSyncError>
+        sendSync(U &&element, const std::optional<std::chrono::milliseconds> timeout = std::nullopt) {
+            while (true) {
+                if (mCore->closed)
+                    return std::unexpected{SendSyncError::Disconnected};
+
+                if (const auto index = mCore->reserve()) {
+                    mCore->slots[*index] = std::forward<U>(element);
+                    mCore->commit(*index);
+                    mCore->notify(mCore->receiver);
+                    return {};
+                }
+
+                typename SPSCChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
+                mCore->park(mCore->sender, waiter);
+
+                if ((!full() || mCore->closed) && mCore->unpark(mCore->sender, waiter))
+                    continue;
+
+                if (const auto result = future.wait(timeout); !result) {
+                    assert(result.error() == std::errc::timed_out);
+
+                    if (mCore->unpark(mCore->sender, waiter))
+                        return std::unexpected{SendSyncError::Timeout};
+
+                    // Woken right as it timed out, the waiter must not go away before it is resolved.
+                    std::ignore = future.wait();
+                }
+            }
+        }
+
+        task::Task<void, SendError> send(T element) {
+            while (true) {
+                if (mCore->closed)
+                    co_return std::unexpected{SendError::Disconnected};
+
+                if (const auto index = mCore->reserve()) {
+                    mCore->slots[*index] = std::move(element);
+                    mCore->commit(*index);
+                    mCore->notify(mCore->receiver);
+                    co_return {};
+                }
+
+                typename SPSCChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
+                mCore->park(mCore->sender, waiter);
+
+                if ((!full() || mCore->closed) && mCore->unpark(mCore->sender, waiter))
+                    continue;
+
+                if (const auto result = co_await task::Cancellable{
+                    std::move(future),
+                    [&]() -> std::expected<void, std::error_code> {
+                        if (!mCore->unpark(mCore->sender, waiter))
+                            return std::unexpected{task::Error::CancellationTooLate};
+
+                        waiter.promise.reject(task::Error::Cancelled);
+                        return {};
+                    }
+                }; !result) {
+                    assert(result.error() == std::errc::operation_canceled);
+                    co_return std::unexpected{SendError::Cancelled};
+                }
+            }
+        }
+
+        void close() {
+            mCore->close();
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return mCore->size();
+        }
+
+        [[nodiscard]] std::size_t capacity() const {
+            return mCore->slots.size() - 1;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] bool full() const {
+            return size() == capacity();
+        }
+
+        [[nodiscard]] bool closed() const {
+            return mCore->closed;
+        }
+
+    private:
+        std::shared_ptr<SPSCChannelCore<T>> mCore;
+    };
+
+    template<typename T>
+    class SPSCReceiver {
+    public:
+        explicit SPSCReceiver(std::shared_ptr<SPSCChannelCore<T>> core) : mCore{std::move(core)} {
+        }
+
+        SPSCReceiver(SPSCReceiver &&rhs) = default;
+        SPSCReceiver &operator=(SPSCReceiver &&rhs) noexcept = default;
+
+        ~SPSCReceiver() {
+            if (!mCore)
+                return;
+
+            mCore->close();
+        }
+
+        std::expected<T, TryReceiveError> tryReceive() {
+            const auto index = mCore->acquire();
+
+            if (!index)
+                return std::unexpected{mCore->closed ? TryReceiveError::Disconnected : TryReceiveError::Empty};
+
+            auto element = std::move(mCore->slots[*index]);
+
+            mCore->release(*index);
+            mCore->notify(mCore->sender);
+
+            return element;
+        }
+
+        std::expected<T, ReceiveSyncError>
+        receiveSync(const std::optional<std::chrono::milliseconds> timeout = std::nullopt) {
+            while (true) {
+                if (const auto index = mCore->acquire()) {
+                    auto element = std::move(mCore->slots[*index]);
+                    mCore->release(*index);
+                    mCore->notify(mCore->sender);
+                    return element;
+                }
+
+                // Elements sent before the channel was closed are still delivered.
+                if (mCore->closed && empty())
+                    return std::unexpected{ReceiveSyncError::Disconnected};
+
+                typename SPSCChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
+                mCore->park(mCore->receiver, waiter);
+
+                if ((!empty() || mCore->closed) && mCore->unpark(mCore->receiver, waiter))
+                    continue;
+
+                if (const auto result = future.wait(timeout); !result) {
+                    assert(result.error() == std::errc::timed_out);
+
+                    if (mCore->unpark(mCore->receiver, waiter))
+                        return std::unexpected{ReceiveSyncError::Timeout};
+
+                    std::ignore = future.wait();
+                }
+            }
+        }
+
+        task::Task<T, ReceiveError> receive() {
+            while (true) {
+                if (const auto index = mCore->acquire()) {
+                    auto element = std::move(mCore->slots[*index]);
+                    mCore->release(*index);
+                    mCore->notify(mCore->sender);
+                    co_return element;
+                }
+
+                if (mCore->closed && empty())
+                    co_return std::unexpected{ReceiveError::Disconnected};
+
+                typename SPSCChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
+                mCore->park(mCore->receiver, waiter);
+
+                if ((!empty() || mCore->closed) && mCore->unpark(mCore->receiver, waiter))
+                    continue;
+
+                if (const auto result = co_await task::Cancellable{
+                    std::move(future),
+                    [&]() -> std::expected<void, std::error_code> {
+                        if (!mCore->unpark(mCore->receiver, waiter))
+                            return std::unexpected{task::Error::CancellationTooLate};
+
+                        waiter.promise.reject(task::Error::Cancelled);
+                        return {};
+                    }
+                }; !result) {
+                    assert(result.error() == std::errc::operation_canceled);
+                    co_return std::unexpected{ReceiveError::Cancelled};
+                }
+            }
+        }
+
+        void close() {
+            mCore->close();
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return mCore->size();
+        }
+
+        [[nodiscard]] std::size_t capacity() const {
+            return mCore->slots.size() - 1;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] bool full() const {
+            return size() == capacity();
+        }
+
+        [[nodiscard]] bool closed() const {
+            return mCore->closed;
+        }
+
+    private:
+        std::shared_ptr<SPSCChannelCore<T>> mCore;
+    };
+
+    template<typename T>
+    using SPSCChannel = std::pair<SPSCSender<T>, SPSCReceiver<T>>;
+
+    // Both ends are move-only, so that there can never be a second sender or receiver.
+    template<typename T>
+    SPSCChannel<T> spscChannel(std::shared_ptr<EventLoop> eventLoop, const std::size_t capacity = 1) {
+        const auto core = std::make_shared<SPSCChannelCore<T>>(std::move(eventLoop), capacity);
+        return {SPSCSender<T>{core}, SPSCReceiver<T>{core}};
+    }
+
+    template<typename T>
+    SPSCChannel<T> spscChannel(const std::size_t capacity = 1) {
+        return spscChannel<T>(getEventLoop(), capacity);
+    }
+}
+
+#endif //ASYNCIO_SPSC_CHANNEL_H
@@ -3,12 +3,27 @@
 
 #include "promise.h"
 #include <list>
+#include <mutex>
 #include <algorithm>
 #include <coroutine>
 #include <exception>
 #include <source_location>
 #include <treehh/tree.hh>
 
+#if defined(__clang__) && defined(__has_cpp_attribute)
+#if __has_cpp_attribute(clang::coro_await_elidable)
+#define ASYNCIO_CORO_AWAIT_ELIDABLE [[clang::coro_await_elidable]]
+#endif
+#endif
+
+#ifndef ASYNCIO_CORO_AWAIT_ELIDABLE
+#define ASYNCIO_CORO_AWAIT_ELIDABLE
+#endif
+
+namespace asyncio {
+    class EventLoopGroup;
+}
+
 namespace asyncio::task {
     Z_DEFINE_ERROR_CODE_EX(
         Error,
@@ -20,21 +35,255 @@ namespace asyncio::task {
         AlreadyCompleted, "Task is already completed", std::errc::operation_not_permitted
     )
 
+    struct FrameAllocatorStatistics {
+        std::size_t allocations;
+        std::size_t hits;
+        std::size_t deallocations;
+    };
+
+    // Coroutine frames and task state are recycled through per-thread size-class freelists.
+    void *allocateFrame(std::size_t size);
+    void deallocateFrame(void *ptr, std::size_t size) noexcept;
+
+    // Statistics of the calling thread.
+    FrameAllocatorStatistics frameAllocatorStatistics();
+
+    struct CPUTime {
+        std::source_location location;
+        std::chrono::nanoseconds time;
+        std::size_t resumes;
+    };
+
+#ifdef ASYNCIO_CPU_ACCOUNTING
+    // A segment is opened whenever a task resumes, and closed by the next one or once the event loop gets control back.
+    void beginSegment(const std::optional<std::source_location> &location);
+    void endSegment();
+#endif
+
+    // The await sites of the calling thread that tasks ran longest after resuming from, empty unless accounting is enabled.
+    std::vector<CPUTime> cpuTime(std::size_t n = 10);
+    void resetCPUTime();
+    // Intrusive reference with a non-atomic count, frames are only touched and released by the event loop they belong to.
+    // Intrusive reference with a non-atomic count, frames are only ever touched by the event loop they belong to.
+    template<typename T>
+    class FramePtr {
+    public:
+        FramePtr() = default;
+
+        explicit FramePtr(T *ptr) : mPtr{ptr} {
+            if (mPtr)
+                ++mPtr->references;
+        }
+
+        FramePtr(const FramePtr &rhs) : FramePtr{rhs.mPtr} {
+        }
+
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        template<typename U>
+            requires std::derived_from<U, T>
+        FramePtr(const FramePtr<U> &rhs) : FramePtr{rhs.get()} {
+        }
+
+        FramePtr(FramePtr &&rhs) noexcept : mPtr{std::exchange(rhs.mPtr, nullptr)} {
+        }
+
+        FramePtr &operator=(FramePtr rhs) noexcept {
+            std::swap(mPtr, rhs.mPtr);
+            return *this;
+        }
+
+        ~FramePtr() {
+            if (mPtr && --mPtr->references == 0)
+                delete mPtr;
+        }
+
+        [[nodiscard]] T *get() const {
+            return mPtr;
+        }
+
+        T *operator->() const {
+            return mPtr;
+        }
+
+        T &operator*() const {
+            return *mPtr;
+        }
+
+        explicit operator bool() const {
+            return mPtr != nullptr;
+        }
+
+        bool operator==(const FramePtr &) const = default;
+
+    private:
+        T *mPtr{};
+    };
+
+    class TaskGroup;
+
+    // Only the next frame created on the calling thread starts with this deadline, which `withDeadline` sets for `f`.
+    std::optional<std::chrono::steady_clock::time_point> takeStartingDeadline();
+    std::optional<std::chrono::steady_clock::time_point>
+    exchangeStartingDeadline(std::optional<std::chrono::steady_clock::time_point> deadline);
+
+    // Numbers frames in creation order, every thread takes a range of its own so that no two frames share one.
+    std::uint64_t nextFrameSequence();
+
+    // Hands the frames of a task spawned onto an event loop group over from one event loop to another.
+    struct Migration {
+        std::mutex mutex;
+        std::shared_ptr<EventLoop> eventLoop;
+    };
+
+    struct Frame {
+        Frame();
+        Frame(const Frame &) = delete;
+        Frame &operator=(const Frame &) = delete;
+        virtual ~Frame();
+
+        static void *operator new(const std::size_t size) {
+            return allocateFrame(size);
+        }
+
+        static void operator delete(void *ptr, const std::size_t size) noexcept {
+            deallocateFrame(ptr, size);
+        }
+
+        // Unlike the address, which the frame pool hands out again right away, never reused.
+        std::uint64_t sequence{nextFrameSequence()};
+        // Only valid while the parent keeps this frame in its children.
+        Frame *parent{};
+        std::list<FramePtr<Frame>> children;
+        // The group being awaited, its members are children as well without being copied into `children`.
+        TaskGroup *group{};
+        std::optional<std::source_location> location;
+        std::function<std::expected<void, std::error_code>()> cancel;
+        std::list<std::function<void()>> callbacks;
+        std::shared_ptr<EventLoop> eventLoop{getEventLoop()};
+        // Inherited from the lane that is running when the task is created.
+        Priority priority{eventLoop ? eventLoop->priority() : Priority::Normal};
+        std::coroutine_handle<> continuation;
+        // Only set on the root frame of a task spawned by `EventLoopGroup::submit`.
+        Migration *migration{};
+        // The migratable root that was running when the frame was created, kept alive until the frame goes away.
+        FramePtr<Frame> origin;
+        // Only counted on a migratable root, the frames created under it that are still alive.
+        std::size_t descendants{0};
+        // Also passed down to the children when they are awaited, unless they have an earlier one.
+        std::optional<std::chrono::steady_clock::time_point> deadline{takeStartingDeadline()};
+        // Linked into the registry of its event loop, except while it is handed over to another one.
+        FrameRegistry *registry{};
+        Frame *prev{};
+        Frame *next{};
+        // When the pending await started, only taken while a slow await detector is attached to the event loop.
+        std::optional<std::chrono::steady_clock::time_point> suspended;
+        // The await the task resumed from last, only kept while a watchdog watches the event loop.
+        std::optional<std::source_location> resumed;
+        std::size_t references{0};
+        bool finished{false};
+        bool locked{false};
+        bool cancelled{false};
+
+        void attach(FrameRegistry &frames);
+        void detach();
+        void suspend(const std::source_location &awaited);
+        void step();
+        void end();
+        std::expected<void, std::error_code> cancelAll();
+        // The frames being awaited, the members of an awaited group included.
+        [[nodiscard]] std::vector<Frame *> awaited() const;
+
+        [[nodiscard]] bool expired() const {
+            return deadline && *deadline <= std::chrono::steady_clock::now();
+        }
+
+        // Futures awaited by the task are resumed in its lane.
+        [[nodiscard]] std::shared_ptr<zero::async::promise::IExecutor> executor() const {
+            return {eventLoop, eventLoop->lane(priority)};
+        }
+
+        [[nodiscard]] tree<std::source_location> callTree() const;
+        [[nodiscard]] std::string trace() const;
+    };
+
+    // Frame, continuation and result of a task share a single allocation.
+    template<typename T, typename E>
+    struct State final : Frame {
+        void resolve(std::expected<T, E> &&res) {
+            if (!promise) {
+                result.emplace(std::move(res));
+                return;
+            }
+
+            settle(std::move(res));
+        }
+
+        Future<T, E> future() {
+            if (!promise) {
+                promise.emplace();
+
+                if (result) {
+                    settle(*std::move(result));
+                    result.reset();
+                }
+            }
+
+            return promise->getFuture();
+        }
+
+        void settle(std::expected<T, E> &&res) {
+            if (!res) {
+                promise->reject(std::move(res).error());
+                return;
+            }
+
+            if constexpr (std::is_void_v<T>)
+                promise->resolve();
+            else
+                promise->resolve(*std::move(res));
+        }
+
+        std::optional<std::expected<T, E>> result;
+        // Only created when the result is consumed through a future, e.g. by `all` or from another event loop.
+        std::optional<asyncio::Promise<T, E>> promise;
+    };
+
     template<typename T, typename E = std::exception_ptr>
     struct Awaitable {
         [[nodiscard]] bool await_ready() {
-            if (!future.isReady())
+            if (state) {
+                if (!state->result)
+                    return false;
+            }
+            else if (!future->isReady()) {
                 return false;
+            }
 
-            if (onReady)
-                std::exchange(onReady, nullptr)();
+            // Ready, but the event loop has run long enough without polling, so yield before taking the result.
+            if (!consumeBudget()) {
+                exhausted = true;
+                return false;
+            }
 
-            result.emplace(std::move(future).result());
+            take();
             return true;
         }
 
         void await_suspend(const std::coroutine_handle<> handle) {
-            future.setCallback([=, this](std::expected<T, E> &&res) {
+            if (exhausted) {
+                getEventLoop()->defer([=] {
+                    handle.resume();
+                });
+                return;
+            }
+
+            // The awaited task runs on the same event loop, it will transfer control to us when it completes.
+            if (state) {
+                state->continuation = handle;
+                return;
+            }
+
+            future->setCallback([=, this](std::expected<T, E> &&res) {
                 if (onReady)
                     std::exchange(onReady, nullptr)();
 
@@ -54,10 +303,16 @@ namespace asyncio::task {
         }
 
         std::expected<T, E> await_resume() requires (!std::same_as<E, std::exception_ptr>) {
+            if (!result)
+                take();
+
             return std::move(*result);
         }
 
         T await_resume() requires std::same_as<E, std::exception_ptr> {
+            if (!result)
+                take();
+
             if (!result->has_value())
                 std::rethrow_exception(result->error());
 
@@ -67,34 +322,47 @@ namespace asyncio::task {
                 return;
         }
 
-        Future<T, E> future;
+        // The state may be released once the awaiting frame steps forward, so take the result first.
+        void take() {
+            if (!state) {
+                if (onReady)
+                    std::exchange(onReady, nullptr)();
+
+                result.emplace(std::move(*future).result());
+                return;
+            }
+
+            if (consume) {
+                result.emplace(*std::move(state->result));
+                state->result.reset();
+            }
+            else if constexpr (std::copy_constructible<std::expected<T, E>>) {
+                result.emplace(*state->result);
+            }
+
+            state = nullptr;
+
+            if (onReady)
+                std::exchange(onReady, nullptr)();
+        }
+
+        std::optional<Future<T, E>> future;
         std::function<void()> onReady;
         std::optional<std::expected<T, E>> result;
+        State<T, E> *state{};
+        // Off when the task was awaited as an lvalue, its result then stays in place for a later await or future.
+        bool consume{true};
+        bool exhausted{false};
     };
 
     template<typename T, typename E>
     class Promise;
 
-    class TaskGroup;
-
-    struct Frame {
-        std::weak_ptr<Frame> parent;
-        std::list<std::shared_ptr<Frame>> children;
-        std::optional<std::source_location> location;
-        std::function<std::expected<void, std::error_code>()> cancel;
-        std::list<std::function<void()>> callbacks;
-        std::shared_ptr<EventLoop> eventLoop{getEventLoop()};
-        bool finished{false};
-        bool locked{false};
-        bool cancelled{false};
-
-        void step();
-        void end();
-        std::expected<void, std::error_code> cancelAll();
+    template<typename T, typename E>
+    class LazyPromise;
 
-        [[nodiscard]] tree<std::source_location> callTree() const;
-        [[nodiscard]] std::string trace() const;
-    };
+    template<typename T, typename E = std::exception_ptr>
+    class Lazy;
 
     template<typename T>
         requires (
@@ -119,10 +387,53 @@ namespace asyncio::task {
     struct Backtrace {
     };
 
+    struct Migratable {
+    };
+
+    struct Prioritize {
+        Priority priority;
+    };
+
+    struct Deadline {
+    };
+
     inline constexpr Cancelled cancelled;
     inline constexpr Lock lock;
     inline constexpr Unlock unlock;
     inline constexpr Backtrace backtrace;
+    inline constexpr Migratable migratable;
+    inline constexpr Deadline deadline;
+
+    constexpr Prioritize prioritize(const Priority priority) {
+        return {priority};
+    }
+
+    /*
+     * Offers the suspended task to the work-stealing scheduler of the calling thread, returns false if it is declined.
+     * Task handles are bound to the event loop of their frame, so it is declined while the chain still holds frames
+     * it created outside of itself, such as a task kept in a local variable.
+     */
+    bool migrate(Frame *frame, std::coroutine_handle<> handle);
+
+    // The migratable root that frames created on the calling thread from now on are counted against, if any.
+    void setOrigin(Frame *root);
+
+    struct MigrationAwaitable {
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        [[nodiscard]] bool await_suspend(const std::coroutine_handle<> handle) const {
+            return migrate(frame, handle);
+        }
+
+        // Also stepped when the offer is declined and the task goes on without suspending.
+        void await_resume() const {
+            frame->step();
+        }
+
+        Frame *frame;
+    };
 
     template<typename F, typename T>
     using InvokeResult = std::conditional_t<
@@ -156,16 +467,14 @@ namespace asyncio::task {
         using error_type = E;
         using promise_type = Promise<T, E>;
 
-        Task(std::shared_ptr<Frame> frame, std::shared_ptr<asyncio::Promise<T, E>> promise)
-            : mFrame{std::move(frame)}, mPromise{std::move(promise)} {
+        explicit Task(FramePtr<State<T, E>> frame) : mFrame{std::move(frame)} {
         }
 
-        Task(Task &&rhs) noexcept : mFrame{std::move(rhs.mFrame)}, mPromise{std::move(rhs.mPromise)} {
+        Task(Task &&rhs) noexcept : mFrame{std::move(rhs.mFrame)} {
         }
 
         Task &operator=(Task &&rhs) noexcept {
             mFrame = std::move(rhs.mFrame);
-            mPromise = std::move(rhs.mPromise);
             return *this;
         }
 
@@ -295,19 +604,20 @@ namespace asyncio::task {
         }
 
         Future<T, E> future() {
-            return mPromise->getFuture().via(mFrame->eventLoop);
+            return mFrame->future().via(mFrame->eventLoop);
         }
 
     private:
-        std::shared_ptr<Frame> mFrame;
-        std::shared_ptr<asyncio::Promise<T, E>> mPromise;
-
-        template<typename, typename>
-        friend class PromiseBase;
+        FramePtr<State<T, E>> mFrame;
 
         friend class TaskGroup;
+        friend class AwaitTransform;
+        friend class asyncio::EventLoopGroup;
     };
 
+    template<typename T, typename E>
+    Task<T, E> from(Lazy<T, E> lazy);
+
     class TaskGroup {
     public:
         [[nodiscard]] bool cancelled() const;
@@ -323,52 +633,114 @@ namespace asyncio::task {
             if (mCancelled)
                 std::ignore = task.cancel();
 
-            auto frame = task.mFrame;
-            mFrames.push_back(frame);
+            // The position in the list is the membership handle, so a completed task leaves the group in constant time.
+            const auto it = mFrames.insert(mFrames.end(), FramePtr<Frame>{task.mFrame});
 
-            // Although a circular reference is created, it will be broken after the task is completed.
-            task.addCallback([frame = std::move(frame), this] {
-                mFrames.remove(frame);
+            // The member is finished, so it no longer counts as a child of the frame awaiting the group.
+            task.addCallback([it, this] {
+                (*it)->parent = nullptr;
+                mFrames.erase(it);
             });
         }
 
+        // Starts the lazy task, the returned handle is the only way to its result.
+        template<typename T, typename E>
+        Task<T, E> add(Lazy<T, E> lazy) {
+            auto task = from(std::move(lazy));
+            add(task);
+            return task;
+        }
+
     private:
         bool mCancelled{false};
-        std::list<std::shared_ptr<Frame>> mFrames;
-
-        template<typename T, typename E>
-        friend class PromiseBase;
+        std::list<FramePtr<Frame>> mFrames;
 
         friend struct Frame;
+        friend class AwaitTransform;
     };
 
     template<typename T, typename E>
-    class PromiseBase {
-    public:
-        PromiseBase() : mFrame{std::make_shared<Frame>()}, mPromise{std::make_shared<asyncio::Promise<T, E>>()} {
+    struct LazyAwaitable {
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
         }
 
-        std::suspend_never initial_suspend() {
-            return {};
+        // Start the lazy task by symmetric transfer, it transfers control back to us when it completes.
+        std::coroutine_handle<> await_suspend(const std::coroutine_handle<> handle) {
+            lazy.mHandle.promise().mContinuation = handle;
+
+            if (!consumeBudget()) {
+                getEventLoop()->defer([handle = lazy.mHandle] {
+                    handle.resume();
+                });
+                return std::noop_coroutine();
+            }
+
+            return lazy.mHandle;
         }
 
-        std::suspend_never final_suspend() noexcept {
-            return {};
+        std::expected<T, E> await_resume() requires (!std::same_as<E, std::exception_ptr>) {
+            return *std::move(lazy.mHandle.promise().mResult);
         }
 
-        void unhandled_exception() {
-            mFrame->end();
+        T await_resume() requires std::same_as<E, std::exception_ptr> {
+            auto &result = lazy.mHandle.promise().mResult;
 
-            if constexpr (std::is_same_v<E, std::exception_ptr>)
-                mPromise->reject(std::current_exception());
+            if (!result->has_value())
+                std::rethrow_exception(result->error());
+
+            if constexpr (!std::is_void_v<T>)
+                return *std::move(*result);
             else
-                std::rethrow_exception(std::current_exception());
+                return;
         }
 
-        Task<T, E> get_return_object() {
-            return {mFrame, mPromise};
+        Lazy<T, E> lazy;
+    };
+
+    // Starts only when awaited and runs on the frame of the awaiting task, without a frame of its own.
+    // When awaited immediately, the coroutine frame lives no longer than the awaiting expression, so it can be elided.
+    template<typename T, typename E>
+    class ASYNCIO_CORO_AWAIT_ELIDABLE Lazy {
+    public:
+        using value_type = T;
+        using error_type = E;
+        using promise_type = LazyPromise<T, E>;
+
+        explicit Lazy(const std::coroutine_handle<promise_type> handle) : mHandle{handle} {
+        }
+
+        Lazy(Lazy &&rhs) noexcept : mHandle{std::exchange(rhs.mHandle, nullptr)} {
+        }
+
+        Lazy &operator=(Lazy &&rhs) noexcept {
+            if (this == &rhs)
+                return *this;
+
+            if (mHandle)
+                mHandle.destroy();
+
+            mHandle = std::exchange(rhs.mHandle, nullptr);
+            return *this;
         }
 
+        ~Lazy() {
+            if (mHandle)
+                mHandle.destroy();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> mHandle;
+
+        template<typename, typename>
+        friend struct LazyAwaitable;
+
+        friend class AwaitTransform;
+    };
+
+    // Await transformations shared by tasks and lazy tasks, bound to the frame of the task that is running.
+    class AwaitTransform {
+    public:
         [[nodiscard]] Awaitable<bool> await_transform(const Cancelled) const {
             return {Future<bool>::resolved(mFrame->cancelled)};
         }
@@ -384,6 +756,50 @@ namespace asyncio::task {
             return {Future<void>::resolved()};
         }
 
+        // The task holds no handles bound to its event loop here, so it may be resumed on another one.
+        [[nodiscard]] MigrationAwaitable
+        await_transform(const Migratable, const std::source_location location = std::source_location::current()) const {
+            mFrame->suspend(location);
+
+            // A queued task is resumed as soon as a worker gets to it, the cancellation is seen by its next await.
+            mFrame->cancel = []() -> std::expected<void, std::error_code> {
+                return {};
+            };
+
+            return {mFrame};
+        }
+
+        // Moves the task to the lane right away, the tasks it creates from then on inherit the priority.
+        [[nodiscard]] Awaitable<void>
+        await_transform(
+            const Prioritize prioritize,
+            const std::source_location location = std::source_location::current()
+        ) {
+            const auto promise = std::make_shared<asyncio::Promise<void>>();
+
+            mFrame->priority = prioritize.priority;
+            mFrame->suspend(location);
+
+            // The task is resumed within a turn either way, the cancellation is seen by its next await.
+            mFrame->cancel = []() -> std::expected<void, std::error_code> {
+                return {};
+            };
+
+            mFrame->eventLoop->post(
+                [=] {
+                    promise->resolve();
+                },
+                prioritize.priority
+            );
+
+            return {promise->getFuture(), [this] { mFrame->step(); }};
+        }
+
+        [[nodiscard]] Awaitable<std::optional<std::chrono::steady_clock::time_point>>
+        await_transform(const Deadline) const {
+            return {Future<std::optional<std::chrono::steady_clock::time_point>>::resolved(mFrame->deadline)};
+        }
+
         [[nodiscard]] Awaitable<std::vector<std::source_location>>
         await_transform(const Backtrace, const std::source_location location = std::source_location::current()) const {
             const auto &eventLoop = mFrame->eventLoop;
@@ -399,19 +815,19 @@ namespace asyncio::task {
                 ] {
                     std::vector stacktrace{location};
 
-                    auto frame = mFrame->parent.lock();
+                    auto frame = mFrame->parent;
 
                     while (frame) {
                         assert(frame->location);
                         stacktrace.push_back(*frame->location);
-                        frame = frame->parent.lock();
+                        frame = frame->parent;
                     }
 
                     promise->resolve(std::move(stacktrace));
                 }
             );
 
-            mFrame->location = location;
+            mFrame->suspend(location);
             return {std::move(future), [this] { mFrame->step(); }};
         }
 
@@ -421,14 +837,15 @@ namespace asyncio::task {
             Cancellable<SemiFuture<Value, Error>> cancellable,
             const std::source_location location = std::source_location::current()
         ) {
-            mFrame->location = location;
+            mFrame->suspend(location);
 
-            if (mFrame->cancelled && !mFrame->locked)
+            // Once the deadline has passed, the leaf is cancelled before it waits at all.
+            if ((mFrame->cancelled || mFrame->expired()) && !mFrame->locked)
                 std::ignore = cancellable.cancel();
             else
                 mFrame->cancel = std::move(cancellable.cancel);
 
-            return {std::move(cancellable.awaitable).via(mFrame->eventLoop), [this] { mFrame->step(); }};
+            return {std::move(cancellable.awaitable).via(mFrame->executor()), [this] { mFrame->step(); }};
         }
 
         template<typename Value, typename Error>
@@ -437,14 +854,14 @@ namespace asyncio::task {
             Cancellable<Future<Value, Error>> cancellable,
             const std::source_location location = std::source_location::current()
         ) {
-            mFrame->location = location;
+            mFrame->suspend(location);
 
-            if (mFrame->cancelled && !mFrame->locked)
+            if ((mFrame->cancelled || mFrame->expired()) && !mFrame->locked)
                 std::ignore = cancellable.cancel();
             else
                 mFrame->cancel = std::move(cancellable.cancel);
 
-            return {std::move(cancellable.awaitable).via(mFrame->eventLoop), [this] { mFrame->step(); }};
+            return {std::move(cancellable.awaitable).via(mFrame->executor()), [this] { mFrame->step(); }};
         }
 
         template<typename Value, typename Error>
@@ -455,14 +872,15 @@ namespace asyncio::task {
         ) {
             cancellable.awaitable.mFrame->parent = mFrame;
             mFrame->children.push_back(cancellable.awaitable.mFrame);
-            mFrame->location = location;
+            inherit(*cancellable.awaitable.mFrame);
+            mFrame->suspend(location);
 
-            if (mFrame->cancelled && !mFrame->locked)
+            if ((mFrame->cancelled || mFrame->expired()) && !mFrame->locked)
                 std::ignore = cancellable.cancel();
             else
                 mFrame->cancel = std::move(cancellable.cancel);
 
-            return {cancellable.awaitable.future(), [this] { mFrame->step(); }};
+            return awaitTask(cancellable.awaitable, true);
         }
 
         template<typename Value, typename Error>
@@ -471,8 +889,8 @@ namespace asyncio::task {
             SemiFuture<Value, Error> future,
             const std::source_location location = std::source_location::current()
         ) {
-            mFrame->location = location;
-            return {std::move(future).via(mFrame->eventLoop), [this] { mFrame->step(); }};
+            mFrame->suspend(location);
+            return {std::move(future).via(mFrame->executor()), [this] { mFrame->step(); }};
         }
 
         template<typename Value, typename Error>
@@ -481,8 +899,8 @@ namespace asyncio::task {
             Future<Value, Error> future,
             const std::source_location location = std::source_location::current()
         ) {
-            mFrame->location = location;
-            return {std::move(future).via(mFrame->eventLoop), [this] { mFrame->step(); }};
+            mFrame->suspend(location);
+            return {std::move(future).via(mFrame->executor()), [this] { mFrame->step(); }};
         }
 
         template<typename Value, typename Error>
@@ -493,12 +911,13 @@ namespace asyncio::task {
         ) {
             task.mFrame->parent = mFrame;
             mFrame->children.push_back(task.mFrame);
-            mFrame->location = location;
+            inherit(*task.mFrame);
+            mFrame->suspend(location);
 
             if (mFrame->cancelled && !mFrame->locked)
                 std::ignore = task.cancel();
 
-            return {task.future(), [this] { mFrame->step(); }};
+            return awaitTask(task, true);
         }
 
         template<typename Value, typename Error>
@@ -509,12 +928,19 @@ namespace asyncio::task {
         ) {
             task.mFrame->parent = mFrame;
             mFrame->children.push_back(task.mFrame);
-            mFrame->location = location;
+            inherit(*task.mFrame);
+            mFrame->suspend(location);
 
             if (mFrame->cancelled && !mFrame->locked)
                 std::ignore = task.cancel();
 
-            return {task.future(), [this] { mFrame->step(); }};
+            return awaitTask(task, false);
+        }
+
+        template<typename Value, typename Error>
+        LazyAwaitable<Value, Error> await_transform(Lazy<Value, Error> &&lazy) {
+            static_cast<AwaitTransform &>(lazy.mHandle.promise()).mFrame = mFrame;
+            return {std::move(lazy)};
         }
 
         Awaitable<void>
@@ -527,6 +953,7 @@ namespace asyncio::task {
 
             for (const auto &frame: group.mFrames) {
                 frame->parent = mFrame;
+                inherit(*frame);
 
                 auto callback = [=] {
                     if (--*count > 0)
@@ -541,25 +968,110 @@ namespace asyncio::task {
                  * otherwise the upper-level coroutine might return immediately, causing the task group to be destroyed.
                  */
                 if (frame->finished) {
-                    mFrame->eventLoop->post(std::move(callback));
+                    mFrame->eventLoop->post(std::move(callback), mFrame->priority);
                     continue;
                 }
 
                 frame->callbacks.emplace_back(std::move(callback));
             }
 
-            mFrame->children = group.mFrames;
-            mFrame->location = location;
+            mFrame->group = &group;
+            mFrame->suspend(location);
 
             if (mFrame->cancelled && !mFrame->locked)
                 std::ignore = group.cancel();
 
-            return {promise->getFuture().via(mFrame->eventLoop), [this] { mFrame->step(); }};
+            return {promise->getFuture().via(mFrame->executor()), [this] { mFrame->step(); }};
         }
 
     protected:
-        std::shared_ptr<Frame> mFrame;
-        std::shared_ptr<asyncio::Promise<T, E>> mPromise;
+        void inherit(Frame &child) const {
+            if (!mFrame->deadline)
+                return;
+
+            if (child.deadline && *child.deadline <= *mFrame->deadline)
+                return;
+
+            child.deadline = mFrame->deadline;
+        }
+
+        template<typename Value, typename Error>
+        Awaitable<Value, Error> awaitTask(Task<Value, Error> &task, const bool consume) {
+            if (task.mFrame->eventLoop != mFrame->eventLoop || task.mFrame->promise)
+                return {task.future(), [this] { mFrame->step(); }};
+
+            // A result that can not be copied is kept for the lvalue by settling it through the future instead.
+            if constexpr (!std::copy_constructible<std::expected<Value, Error>>) {
+                if (!consume)
+                    return {task.future(), [this] { mFrame->step(); }};
+            }
+
+            return {std::nullopt, [this] { mFrame->step(); }, std::nullopt, task.mFrame.get(), consume};
+        }
+
+        Frame *mFrame{};
+    };
+
+    template<typename T, typename E>
+    class PromiseBase : public AwaitTransform {
+    public:
+        PromiseBase() : mState{new State<T, E>()} {
+            mFrame = mState.get();
+        }
+
+        static void *operator new(const std::size_t size) {
+            return allocateFrame(size);
+        }
+
+        static void operator delete(void *ptr, const std::size_t size) noexcept {
+            deallocateFrame(ptr, size);
+        }
+
+        std::suspend_never initial_suspend() {
+            return {};
+        }
+
+        struct FinalAwaitable {
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            // Symmetric transfer to the awaiting coroutine, so that a chain of tasks completes without queue hops.
+            std::coroutine_handle<> await_suspend(const std::coroutine_handle<> handle) const noexcept {
+                const auto continuation = std::exchange(frame->continuation, nullptr);
+                handle.destroy();
+
+                if (!continuation)
+                    return std::noop_coroutine();
+
+                return continuation;
+            }
+
+            void await_resume() const noexcept {
+            }
+
+            Frame *frame;
+        };
+
+        FinalAwaitable final_suspend() noexcept {
+            return {mFrame};
+        }
+
+        void unhandled_exception() {
+            mState->end();
+
+            if constexpr (std::is_same_v<E, std::exception_ptr>)
+                mState->resolve(std::unexpected{std::current_exception()});
+            else
+                std::rethrow_exception(std::current_exception());
+        }
+
+        Task<T, E> get_return_object() {
+            return Task<T, E>{mState};
+        }
+
+    protected:
+        FramePtr<State<T, E>> mState;
     };
 
     template<typename T, typename E>
@@ -567,45 +1079,108 @@ namespace asyncio::task {
     public:
         template<typename U = T>
         void return_value(U &&value) requires std::same_as<E, std::exception_ptr> {
-            this->mFrame->end();
-            this->mPromise->resolve(std::forward<U>(value));
+            this->mState->end();
+            this->mState->resolve(std::expected<T, E>{std::in_place, std::forward<U>(value)});
         }
 
         void return_value(std::expected<T, E> &&result) requires (!std::same_as<E, std::exception_ptr>) {
-            this->mFrame->end();
+            this->mState->end();
+            this->mState->resolve(std::move(result));
+        }
 
-            if (!result) {
-                this->mPromise->reject(std::move(result).error());
-                return;
-            }
+        void return_value(const std::expected<T, E> &result) requires (!std::same_as<E, std::exception_ptr>) {
+            this->mState->end();
+            this->mState->resolve(std::expected<T, E>{result});
+        }
+    };
 
-            if constexpr (std::is_void_v<T>)
-                this->mPromise->resolve();
-            else
-                this->mPromise->resolve(std::move(result).value());
+    template<>
+    class Promise<void, std::exception_ptr> final : public PromiseBase<void, std::exception_ptr> {
+    public:
+        void return_void() {
+            this->mState->end();
+            this->mState->resolve({});
         }
+    };
 
-        void return_value(const std::expected<T, E> &result) requires (!std::same_as<E, std::exception_ptr>) {
-            this->mFrame->end();
+    template<typename T, typename E>
+    class LazyPromiseBase : public AwaitTransform {
+    public:
+        static void *operator new(const std::size_t size) {
+            return allocateFrame(size);
+        }
 
-            if (!result) {
-                this->mPromise->reject(result.error());
-                return;
+        static void operator delete(void *ptr, const std::size_t size) noexcept {
+            deallocateFrame(ptr, size);
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        struct FinalAwaitable {
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
             }
 
-            if constexpr (std::is_void_v<T>)
-                this->mPromise->resolve();
+            // The frame is owned by `Lazy`, so it is not destroyed here.
+            [[nodiscard]] std::coroutine_handle<> await_suspend(const std::coroutine_handle<>) const noexcept {
+                return continuation;
+            }
+
+            void await_resume() const noexcept {
+            }
+
+            std::coroutine_handle<> continuation;
+        };
+
+        FinalAwaitable final_suspend() noexcept {
+            return {mContinuation};
+        }
+
+        void unhandled_exception() {
+            if constexpr (std::is_same_v<E, std::exception_ptr>)
+                mResult.emplace(std::unexpected{std::current_exception()});
             else
-                this->mPromise->resolve(result.value());
+                std::rethrow_exception(std::current_exception());
+        }
+
+        Lazy<T, E> get_return_object() {
+            return Lazy<T, E>{
+                std::coroutine_handle<LazyPromise<T, E>>::from_promise(static_cast<LazyPromise<T, E> &>(*this))
+            };
+        }
+
+    protected:
+        std::coroutine_handle<> mContinuation;
+        std::optional<std::expected<T, E>> mResult;
+
+        template<typename, typename>
+        friend struct LazyAwaitable;
+    };
+
+    template<typename T, typename E>
+    class LazyPromise final : public LazyPromiseBase<T, E> {
+    public:
+        template<typename U = T>
+        void return_value(U &&value) requires std::same_as<E, std::exception_ptr> {
+            this->mResult.emplace(std::in_place, std::forward<U>(value));
+        }
+
+        void return_value(std::expected<T, E> &&result) requires (!std::same_as<E, std::exception_ptr>) {
+            this->mResult.emplace(std::move(result));
+        }
+
+        void return_value(const std::expected<T, E> &result) requires (!std::same_as<E, std::exception_ptr>) {
+            this->mResult.emplace(result);
         }
     };
 
     template<>
-    class Promise<void, std::exception_ptr> final : public PromiseBase<void, std::exception_ptr> {
+    class LazyPromise<void, std::exception_ptr> final : public LazyPromiseBase<void, std::exception_ptr> {
     public:
         void return_void() {
-            this->mFrame->end();
-            this->mPromise->resolve();
+            this->mResult.emplace();
         }
     };
 
@@ -637,7 +1212,10 @@ namespace asyncio::task {
         using E = std::iter_value_t<I>::error_type;
 
         TaskGroup group;
-        std::list<Future<T, E>> futures;
+        std::vector<Future<T, E>> futures;
+
+        if constexpr (std::sized_sentinel_for<S, I>)
+            futures.reserve(static_cast<std::size_t>(last - first));
 
         while (first != last) {
             group.add(*first);
@@ -713,7 +1291,10 @@ namespace asyncio::task {
         using E = std::iter_value_t<I>::error_type;
 
         TaskGroup group;
-        std::list<Future<T, E>> futures;
+        std::vector<Future<T, E>> futures;
+
+        if constexpr (std::sized_sentinel_for<S, I>)
+            futures.reserve(static_cast<std::size_t>(last - first));
 
         while (first != last) {
             group.add(*first);
@@ -789,7 +1370,10 @@ namespace asyncio::task {
         using E = std::iter_value_t<I>::error_type;
 
         TaskGroup group;
-        std::list<Future<T, E>> futures;
+        std::vector<Future<T, E>> futures;
+
+        if constexpr (std::sized_sentinel_for<S, I>)
+            futures.reserve(static_cast<std::size_t>(last - first));
 
         while (first != last) {
             group.add(*first);
@@ -871,7 +1455,10 @@ namespace asyncio::task {
         using E = std::iter_value_t<I>::error_type;
 
         TaskGroup group;
-        std::list<Future<T, E>> futures;
+        std::vector<Future<T, E>> futures;
+
+        if constexpr (std::sized_sentinel_for<S, I>)
+            futures.reserve(static_cast<std::size_t>(last - first));
 
         while (first != last) {
             group.add(*first);
@@ -950,6 +1537,120 @@ namespace asyncio::task {
         co_return co_await std::move(cancellable);
     }
 
+    template<typename T, typename E>
+    Task<T, E> from(Lazy<T, E> lazy) {
+        co_return co_await std::move(lazy);
+    }
+
+    // The combinators start every `Lazy` passed to them as a task of its own, a range of them is moved from.
+    template<typename T>
+    decltype(auto) start(T &&task) {
+        if constexpr (zero::meta::Specialization<std::remove_cvref_t<T>, Lazy>)
+            return from(std::move(task));
+        else
+            return std::forward<T>(task);
+    }
+
+    template<typename T>
+    using Started = decltype(start(std::declval<T>()));
+
+    template<std::ranges::input_range R>
+    using StartedIterator = std::vector<Started<std::ranges::range_value_t<R>>>::iterator;
+
+    template<std::ranges::input_range R>
+    std::vector<Started<std::ranges::range_value_t<R>>> startEach(R &&lazies) {
+        std::vector<Started<std::ranges::range_value_t<R>>> tasks;
+
+        for (auto &&lazy: lazies)
+            tasks.push_back(from(std::move(lazy)));
+
+        return tasks;
+    }
+
+    template<typename... Ts>
+    concept LazyArguments = (
+        ((zero::meta::Specialization<std::remove_cvref_t<Ts>, Task> || zero::meta::Specialization<Ts, Lazy>) && ...) &&
+        (zero::meta::Specialization<Ts, Lazy> || ...)
+    );
+
+    template<std::ranges::input_range R>
+        requires zero::meta::Specialization<std::ranges::range_value_t<R>, Lazy>
+    Task<
+        AllRangesValue<StartedIterator<R>, StartedIterator<R>>,
+        AllRangesError<StartedIterator<R>, StartedIterator<R>>
+    >
+    all(R &&lazies) {
+        auto tasks = startEach(std::forward<R>(lazies));
+        co_return co_await all(tasks);
+    }
+
+    template<typename... Ts>
+        requires LazyArguments<Ts...>
+    Task<
+        AllVariadicValue<Started<Ts>...>,
+        AllVariadicError<Started<Ts>...>
+    >
+    all(Ts &&... tasks) {
+        co_return co_await all(start(std::forward<Ts>(tasks))...);
+    }
+
+    template<std::ranges::input_range R>
+        requires zero::meta::Specialization<std::ranges::range_value_t<R>, Lazy>
+    Task<AllSettledRangesValue<StartedIterator<R>, StartedIterator<R>>>
+    allSettled(R &&lazies) {
+        auto tasks = startEach(std::forward<R>(lazies));
+        co_return co_await allSettled(tasks);
+    }
+
+    template<typename... Ts>
+        requires LazyArguments<Ts...>
+    Task<AllSettledVariadicValue<Started<Ts>...>>
+    allSettled(Ts &&... tasks) {
+        co_return co_await allSettled(start(std::forward<Ts>(tasks))...);
+    }
+
+    template<std::ranges::input_range R>
+        requires zero::meta::Specialization<std::ranges::range_value_t<R>, Lazy>
+    Task<
+        AnyRangesValue<StartedIterator<R>, StartedIterator<R>>,
+        AnyRangesError<StartedIterator<R>, StartedIterator<R>>
+    >
+    any(R &&lazies) {
+        auto tasks = startEach(std::forward<R>(lazies));
+        co_return co_await any(tasks);
+    }
+
+    template<typename... Ts>
+        requires LazyArguments<Ts...>
+    Task<
+        AnyVariadicValue<Started<Ts>...>,
+        AnyVariadicError<Started<Ts>...>
+    >
+    any(Ts &&... tasks) {
+        co_return co_await any(start(std::forward<Ts>(tasks))...);
+    }
+
+    template<std::ranges::input_range R>
+        requires zero::meta::Specialization<std::ranges::range_value_t<R>, Lazy>
+    Task<
+        RaceRangesValue<StartedIterator<R>, StartedIterator<R>>,
+        RaceRangesError<StartedIterator<R>, StartedIterator<R>>
+    >
+    race(R &&lazies) {
+        auto tasks = startEach(std::forward<R>(lazies));
+        co_return co_await race(tasks);
+    }
+
+    template<typename... Ts>
+        requires LazyArguments<Ts...>
+    Task<
+        RaceVariadicValue<Started<Ts>...>,
+        RaceVariadicError<Started<Ts>...>
+    >
+    race(Ts &&... tasks) {
+        co_return co_await race(start(std::forward<Ts>(tasks))...);
+    }
+
     template<Invocable F>
     std::invoke_result_t<F> spawn(F f) {
         co_return co_await std::invoke(std::move(f));
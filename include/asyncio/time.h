@@ -2,10 +2,93 @@
 #define ASYNCIO_TIME_H
 
 #include "error.h"
+#include <zero/defer.h>
 
 namespace asyncio {
+    // Hierarchical timing wheel of an event loop, all of its timers share a single `uv_timer_t`.
+    class TimerWheel {
+    public:
+        static constexpr std::size_t Levels = 6;
+        static constexpr std::size_t Slots = 64;
+
+        // Intrusive, the owner must keep it alive until it fires or is removed.
+        struct Entry {
+            std::function<void()> callback;
+            std::uint64_t deadline{};
+            Entry *prev{};
+            Entry *next{};
+            std::size_t level{};
+            std::size_t slot{};
+            bool pending{false};
+        };
+
+        TimerWheel(uv::Handle<uv_timer_t> timer, std::chrono::milliseconds resolution);
+        TimerWheel(const TimerWheel &) = delete;
+        TimerWheel &operator=(const TimerWheel &) = delete;
+
+        [[nodiscard]] std::chrono::milliseconds resolution() const;
+        [[nodiscard]] std::size_t size() const;
+
+        void add(Entry &entry, std::chrono::milliseconds delay);
+        // Returns false if the entry has already fired.
+        bool remove(Entry &entry);
+
+    private:
+        struct Expiration {
+            std::size_t level;
+            std::size_t slot;
+            std::uint64_t deadline;
+        };
+
+        [[nodiscard]] std::optional<Expiration> next() const;
+
+        void insert(Entry &entry);
+        void unlink(Entry &entry);
+        void poll();
+        void arm();
+
+        uv::Handle<uv_timer_t> mTimer;
+        std::chrono::milliseconds mResolution;
+        std::uint64_t mOrigin;
+        std::uint64_t mElapsed{0};
+        std::optional<std::uint64_t> mArmed;
+        std::size_t mSize{0};
+        std::array<std::uint64_t, Levels> mOccupied{};
+        std::array<std::array<Entry *, Slots>, Levels> mSlots{};
+        Entry *mFiring{};
+    };
+
     task::Task<void, std::error_code> sleep(std::chrono::milliseconds ms);
 
+    // Ticks at a fixed rate, ticks missed while nobody was waiting collapse into one.
+    class Interval {
+        struct Core {
+            std::shared_ptr<EventLoop> eventLoop;
+            std::chrono::milliseconds period;
+            std::uint64_t next;
+            bool ticked;
+            std::optional<Promise<void, std::error_code>> waiter;
+            TimerWheel::Entry entry;
+        };
+
+    public:
+        explicit Interval(std::chrono::milliseconds period);
+        Interval(Interval &&rhs) noexcept = default;
+        Interval &operator=(Interval &&rhs) noexcept;
+        ~Interval();
+
+        [[nodiscard]] std::chrono::milliseconds period() const;
+
+        task::Task<void, std::error_code> tick();
+
+    private:
+        static void schedule(Core &core);
+        static void release(Core &core);
+
+        // Shared with a pending tick, which may outlive the interval.
+        std::shared_ptr<Core> mCore;
+    };
+
     Z_DEFINE_ERROR_CODE_EX(
         TimeoutError,
         "asyncio::timeout",
@@ -19,24 +102,28 @@ namespace asyncio {
         if (ms == std::chrono::milliseconds::zero())
             co_return std::expected<std::expected<T, E>, TimeoutError>{co_await task};
 
-        auto timer = sleep(ms)
-            .andThen([&] {
-                return task.cancel();
-            });
+        // A bare wheel entry rather than a sleeping task, so guarding an operation costs no extra frame or promise.
+        std::optional<std::expected<void, std::error_code>> cancelled;
+        auto &timerWheel = getEventLoop()->timerWheel();
 
-        auto result = co_await task;
+        TimerWheel::Entry entry{
+            [&] {
+                cancelled.emplace(task.cancel());
+            }
+        };
 
-        if (timer.done()) {
-            if (!timer.future().result())
-                co_return std::expected<std::expected<T, E>, TimeoutError>{std::move(result)};
+        timerWheel.add(entry, ms);
+        auto result = co_await task;
 
-            co_return std::unexpected{TimeoutError::Elapsed};
+        if (!cancelled) {
+            timerWheel.remove(entry);
+            co_return std::expected<std::expected<T, E>, TimeoutError>{std::move(result)};
         }
 
-        std::ignore = timer.cancel();
-        std::ignore = co_await timer;
+        if (!*cancelled)
+            co_return std::expected<std::expected<T, E>, TimeoutError>{std::move(result)};
 
-        co_return std::expected<std::expected<T, E>, TimeoutError>{std::move(result)};
+        co_return std::unexpected{TimeoutError::Elapsed};
     }
 
     template<typename T>
@@ -44,10 +131,16 @@ namespace asyncio {
         if (ms == std::chrono::milliseconds::zero())
             co_return co_await task;
 
-        auto timer = sleep(ms)
-            .andThen([&] {
-                return task.cancel();
-            });
+        std::optional<std::expected<void, std::error_code>> cancelled;
+        auto &timerWheel = getEventLoop()->timerWheel();
+
+        TimerWheel::Entry entry{
+            [&] {
+                cancelled.emplace(task.cancel());
+            }
+        };
+
+        timerWheel.add(entry, ms);
 
         std::optional<std::expected<T, std::exception_ptr>> result;
 
@@ -64,22 +157,10 @@ namespace asyncio {
             result.emplace(std::unexpected{std::current_exception()});
         }
 
-        if (timer.done()) {
-            if (!timer.future().result()) {
-                if (!*result)
-                    std::rethrow_exception(result->error());
-
-                if constexpr (std::is_void_v<T>)
-                    co_return;
-                else
-                    co_return *std::move(*result);
-            }
-
+        if (!cancelled)
+            timerWheel.remove(entry);
+        else if (*cancelled)
             throw co_await error::StacktraceError<std::system_error>::make(TimeoutError::Elapsed);
-        }
-
-        std::ignore = timer.cancel();
-        std::ignore = co_await timer;
 
         if (!*result)
             std::rethrow_exception(result->error());
@@ -91,6 +172,97 @@ namespace asyncio {
     }
 }
 
+namespace asyncio::task {
+    /*
+     * Runs the task created by `f` under a deadline, which every task it awaits inherits.
+     * Other tasks started meanwhile are left alone, `f` is expected to create no task before the one it returns.
+     * The whole subtree is cancelled by a single wheel entry, and none is added if an enclosing deadline comes first.
+     */
+    template<Invocable F>
+        requires (
+            zero::meta::Specialization<std::invoke_result_t<F>, Task> &&
+            (
+                std::same_as<typename std::invoke_result_t<F>::error_type, std::error_code> ||
+                std::same_as<typename std::invoke_result_t<F>::error_type, std::exception_ptr>
+            )
+        )
+    Lazy<typename std::invoke_result_t<F>::value_type, typename std::invoke_result_t<F>::error_type>
+    withDeadline(const std::chrono::steady_clock::time_point tp, F f) {
+        using T = typename std::invoke_result_t<F>::value_type;
+        using E = typename std::invoke_result_t<F>::error_type;
+
+        const auto inherited = co_await deadline;
+        const auto effective = inherited ? (std::min)(*inherited, tp) : tp;
+        const auto armed = !inherited || tp < *inherited;
+
+        // Only the frame of the task `f` creates picks the deadline up, its children get it when they are awaited.
+        auto task = [&] {
+            const auto previous = exchangeStartingDeadline(effective);
+            Z_DEFER(exchangeStartingDeadline(previous));
+            return std::invoke(std::move(f));
+        }();
+
+        auto &timerWheel = getEventLoop()->timerWheel();
+
+        std::optional<std::expected<void, std::error_code>> cancelled;
+
+        TimerWheel::Entry entry{
+            [&] {
+                cancelled.emplace(task.cancel());
+            }
+        };
+
+        if (armed)
+            timerWheel.add(entry, std::chrono::ceil<std::chrono::milliseconds>(tp - std::chrono::steady_clock::now()));
+
+        std::optional<std::expected<T, E>> result;
+
+        if constexpr (std::same_as<E, std::error_code>) {
+            result.emplace(co_await task);
+        }
+        else {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await task;
+                    result.emplace();
+                }
+                else {
+                    result.emplace(co_await task);
+                }
+            }
+            catch (const std::exception &) {
+                result.emplace(std::unexpected{std::current_exception()});
+            }
+        }
+
+        if (armed && !cancelled)
+            timerWheel.remove(entry);
+
+        // Cancelled by our own entry, by an enclosing one, or by a leaf that found the deadline already passed.
+        const auto elapsed = cancelled ? cancelled->has_value() : std::chrono::steady_clock::now() >= effective;
+
+        if (!*result && elapsed) {
+            if constexpr (std::same_as<E, std::error_code>)
+                co_return std::unexpected{TimeoutError::Elapsed};
+            else
+                throw co_await error::StacktraceError<std::system_error>::make(TimeoutError::Elapsed);
+        }
+
+        if constexpr (std::same_as<E, std::error_code>) {
+            co_return *std::move(result);
+        }
+        else {
+            if (!*result)
+                std::rethrow_exception(result->error());
+
+            if constexpr (std::is_void_v<T>)
+                co_return;
+            else
+                co_return **std::move(result);
+        }
+    }
+}
+
 Z_DECLARE_ERROR_CODE(asyncio::TimeoutError)
 
 #endif //ASYNCIO_TIME_H
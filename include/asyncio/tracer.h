@@ -0,0 +1,64 @@
+#ifndef ASYNCIO_TRACER_H
+#define ASYNCIO_TRACER_H
+
+#include "task.h"
+#include <thread>
+#include <filesystem>
+#include <unordered_set>
+#include <condition_variable>
+
+namespace asyncio {
+    /*
+     * Records the lifecycle of every task as Chrome trace events, to be opened in Perfetto or `chrome://tracing`.
+     * Each thread appends to a lock-free ring of its own, which a background thread flushes to the file.
+     * Only one tracer may be active at a time, it may be destroyed while tasks are still running.
+     * Every await of a task links the awaiting parent to the child with a flow arrow.
+     */
+    class Tracer {
+    public:
+        // Single producer, single consumer, only defined in the implementation.
+        struct Ring;
+
+        Tracer(
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> file,
+            std::chrono::milliseconds interval
+        );
+        Tracer(const Tracer &) = delete;
+        Tracer &operator=(const Tracer &) = delete;
+        ~Tracer();
+
+        static std::expected<std::unique_ptr<Tracer>, std::error_code>
+        make(const std::filesystem::path &path, std::chrono::milliseconds interval = std::chrono::milliseconds{100});
+
+        // Events lost because the ring of a thread was full.
+        [[nodiscard]] std::size_t dropped() const;
+
+        // Hooks of the task machinery, they only cost an atomic load while no tracer is active.
+        static void spawned(const task::Frame &frame);
+        static void suspended(const task::Frame &frame);
+        static void resumed(const task::Frame &frame);
+        static void completed(const task::Frame &frame);
+        static void cancelled(const task::Frame &frame);
+        // The running callable has returned to the event loop.
+        static void yielded();
+
+    private:
+        // The ring of the calling thread, registered with the active tracer on first use.
+        static Ring *current();
+        void flush();
+
+        std::uint64_t mGeneration;
+        std::chrono::steady_clock::time_point mEpoch;
+        std::unique_ptr<std::FILE, decltype(&std::fclose)> mFile;
+        bool mFirst{true};
+        // Children with an await arrow still waiting for its end, only touched by the flushing thread.
+        std::unordered_set<std::uint64_t> mAwaited;
+        bool mStopped{false};
+        mutable std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::vector<std::shared_ptr<Ring>> mRings;
+        std::thread mThread;
+    };
+}
+
+#endif //ASYNCIO_TRACER_H
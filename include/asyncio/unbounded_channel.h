@@ -0,0 +1,435 @@
+#ifndef ASYNCIO_UNBOUNDED_CHANNEL_H
+#define ASYNCIO_UNBOUNDED_CHANNEL_H
+
+#include "channel.h"
+#include <array>
+
+namespace asyncio {
+    /*
+     * Elements are kept in a list of fixed-size segments, so that memory grows with the backlog,
+     * drained segments are kept on a short freelist for the next burst and released beyond that.
+     */
+    template<typename T>
+    struct UnboundedChannelCore {
+        static constexpr std::size_t SegmentSize{32};
+        static constexpr std::size_t MaxSpareSegments{4};
+
+        struct Segment {
+            union Slot {
+                Slot() {
+                }
+
+                ~Slot() {
+                }
+
+                T value;
+            };
+
+            std::array<Slot, SegmentSize> slots;
+            Segment *next{};
+        };
+
+        // Only receivers ever wait, linked while they do and guarded by the mutex, the future is taken before linking.
+        struct Waiter {
+            Promise<void, std::error_code> promise;
+            Waiter *prev{};
+            Waiter *next{};
+            bool linked{false};
+        };
+
+        explicit UnboundedChannelCore(std::shared_ptr<EventLoop> e) : eventLoop{std::move(e)} {
+        }
+
+        UnboundedChannelCore(const UnboundedChannelCore &) = delete;
+        UnboundedChannelCore &operator=(const UnboundedChannelCore &) = delete;
+
+        ~UnboundedChannelCore() {
+            while (pop()) {
+            }
+
+            delete head;
+
+            while (spare) {
+                delete std::exchange(spare, spare->next);
+            }
+        }
+
+        std::mutex mutex;
+        std::atomic<bool> closed;
+        std::atomic<std::size_t> size{0};
+        std::shared_ptr<EventLoop> eventLoop;
+        Segment *head{};
+        Segment *tail{};
+        // Read position in the head segment and write position in the tail segment.
+        std::size_t first{0};
+        std::size_t last{0};
+        Segment *spare{};
+        std::size_t spares{0};
+        Waiter *waiters{};
+        Waiter *lastWaiter{};
+        std::atomic<std::size_t> senders;
+        std::atomic<std::size_t> receivers;
+
+        // Called with the mutex held.
+        template<typename U>
+        void push(U &&element) {
+            if (!tail) {
+                head = tail = acquireSegment();
+            }
+            else if (last == SegmentSize) {
+                tail->next = acquireSegment();
+                tail = tail->next;
+                last = 0;
+            }
+
+            std::construct_at(&tail->slots[last].value, std::forward<U>(element));
+            ++last;
+            size.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Called with the mutex held.
+        std::optional<T> pop() {
+            if (!head || (head == tail && first == last))
+                return std::nullopt;
+
+            if (first == SegmentSize) {
+                releaseSegment(std::exchange(head, head->next));
+                first = 0;
+            }
+
+            auto &slot = head->slots[first++].value;
+            std::optional<T> element{std::move(slot)};
+            std::destroy_at(&slot);
+            size.fetch_sub(1, std::memory_order_relaxed);
+
+            // The last segment is rewound rather than recycled once it is drained.
+            if (head == tail && first == last)
+                first = last = 0;
+
+            return element;
+        }
+
+        Segment *acquireSegment() {
+            if (!spare)
+                return new Segment();
+
+            const auto segment = std::exchange(spare, spare->next);
+            segment->next = nullptr;
+            --spares;
+
+            return segment;
+        }
+
+        void releaseSegment(Segment *segment) {
+            if (spares == MaxSpareSegments) {
+                delete segment;
+                return;
+            }
+
+            segment->next = std::exchange(spare, segment);
+            ++spares;
+        }
+
+        // Called with the mutex held, the caller must look at the queue again before waiting.
+        void enqueue(Waiter &waiter) {
+            waiter.prev = lastWaiter;
+            waiter.next = nullptr;
+            waiter.linked = true;
+
+            if (lastWaiter)
+                lastWaiter->next = &waiter;
+            else
+                waiters = &waiter;
+
+            lastWaiter = &waiter;
+        }
+
+        // Called with the mutex held.
+        void unlink(Waiter &waiter) {
+            if (waiter.prev)
+                waiter.prev->next = waiter.next;
+            else
+                waiters = waiter.next;
+
+            if (waiter.next)
+                waiter.next->prev = waiter.prev;
+            else
+                lastWaiter = waiter.prev;
+
+            waiter.linked = false;
+        }
+
+        // Called with the mutex held, the promise is moved out since the waiter may go away as soon as it is resolved.
+        std::optional<Promise<void, std::error_code>> wake() {
+            const auto waiter = waiters;
+
+            if (!waiter)
+                return std::nullopt;
+
+            unlink(*waiter);
+            return std::move(waiter->promise);
+        }
+
+        void close() {
+            std::vector<Promise<void, std::error_code>> promises;
+
+            {
+                const std::lock_guard guard{mutex};
+
+                if (closed)
+                    return;
+
+                closed = true;
+
+                while (auto promise = wake())
+                    promises.push_back(*std::move(promise));
+            }
+
+            for (auto &promise: promises)
+                promise.resolve();
+        }
+    };
+
+    template<typename T>
+    class UnboundedSender {
+    public:
+        explicit UnboundedSender(std::shared_ptr<UnboundedChannelCore<T>> core) : mCore{std::move(core)} {
+            ++mCore->senders;
+        }
+
+        UnboundedSender(const UnboundedSender &rhs) : mCore{rhs.mCore} {
+            ++mCore->senders;
+        }
+
+        UnboundedSender(UnboundedSender &&rhs) = default;
+
+        UnboundedSender &operator=(const UnboundedSender &rhs) {
+            mCore = rhs.mCore;
+            ++mCore->senders;
+            return *this;
+        }
+
+        UnboundedSender &operator=(UnboundedSender &&rhs) noexcept = default;
+
+        ~UnboundedSender() {
+            if (!mCore)
+                return;
+
+            if (--mCore->senders > 0)
+                return;
+
+            mCore->close();
+        }
+
+        // Never waits, the only way to fail is a closed channel.
+        template<typename U = T>
+        std::expected<void, SendError> send(U &&element) {
+            std::optional<Promise<void, std::error_code>> promise;
+
+            {
+                const std::lock_guard guard{mCore->mutex};
+
+                if (mCore->closed)
+                    return std::unexpected{SendError::Disconnected};
+
+                mCore->push(std::forward<U>(element));
+                promise = mCore->wake();
+            }
+
+            if (promise)
+                promise->resolve();
+
+            return {};
+        }
+
+        std::expected<void, std::pair<T, SendError>> sendEx(T &&element) {
+            std::optional<Promise<void, std::error_code>> promise;
+
+            {
+                const std::lock_guard guard{mCore->mutex};
+
+                if (mCore->closed)
+                    return std::unexpected{std::pair{std::move(element), SendError::Disconnected}};
+
+                mCore->push(std::move(element));
+                promise = mCore->wake();
+            }
+
+            if (promise)
+                promise->resolve();
+
+            return {};
+        }
+
+        void close() {
+            mCore->close();
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return mCore->size.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] bool closed() const {
+            return mCore->closed;
+        }
+
+    private:
+        std::shared_ptr<UnboundedChannelCore<T>> mCore;
+    };
+
+    template<typename T>
+    class UnboundedReceiver {
+    public:
+        explicit UnboundedReceiver(std::shared_ptr<UnboundedChannelCore<T>> core) : mCore{std::move(core)} {
+            ++mCore->receivers;
+        }
+
+        UnboundedReceiver(const UnboundedReceiver &rhs) : mCore{rhs.mCore} {
+            ++mCore->receivers;
+        }
+
+        UnboundedReceiver(UnboundedReceiver &&rhs) = default;
+
+        UnboundedReceiver &operator=(const UnboundedReceiver &rhs) {
+            mCore = rhs.mCore;
+            ++mCore->receivers;
+            return *this;
+        }
+
+        UnboundedReceiver &operator=(UnboundedReceiver &&rhs) noexcept = default;
+
+        ~UnboundedReceiver() {
+            if (!mCore)
+                return;
+
+            if (--mCore->receivers > 0)
+                return;
+
+            mCore->close();
+        }
+
+        std::expected<T, TryReceiveError> tryReceive() {
+            const std::lock_guard guard{mCore->mutex};
+
+            if (auto element = mCore->pop())
+                return *std::move(element);
+
+            return std::unexpected{mCore->closed ? TryReceiveError::Disconnected : TryReceiveError::Empty};
+        }
+
+        std::expected<T, ReceiveSyncError>
+        receiveSync(const std::optional<std::chrono::milliseconds> timeout = std::nullopt) {
+            while (true) {
+                typename UnboundedChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
+                {
+                    const std::lock_guard guard{mCore->mutex};
+
+                    if (auto element = mCore->pop())
+                        return *std::move(element);
+
+                    if (mCore->closed)
+                        return std::unexpected{ReceiveSyncError::Disconnected};
+
+                    mCore->enqueue(waiter);
+                }
+
+                if (const auto result = future.wait(timeout); !result) {
+                    assert(result.error() == std::errc::timed_out);
+                    std::optional<Promise<void, std::error_code>> promise;
+
+                    {
+                        const std::lock_guard guard{mCore->mutex};
+
+                        // Woken right as it timed out, so the wakeup is handed on rather than lost.
+                        if (!waiter.linked)
+                            promise = mCore->wake();
+                        else
+                            mCore->unlink(waiter);
+                    }
+
+                    if (promise)
+                        promise->resolve();
+
+                    return std::unexpected{ReceiveSyncError::Timeout};
+                }
+            }
+        }
+
+        task::Task<T, ReceiveError> receive() {
+            while (true) {
+                typename UnboundedChannelCore<T>::Waiter waiter;
+                auto future = waiter.promise.getFuture();
+
+                {
+                    const std::lock_guard guard{mCore->mutex};
+
+                    if (auto element = mCore->pop())
+                        co_return *std::move(element);
+
+                    if (mCore->closed)
+                        co_return std::unexpected{ReceiveError::Disconnected};
+
+                    mCore->enqueue(waiter);
+                }
+
+                if (const auto result = co_await task::Cancellable{
+                    std::move(future),
+                    [&]() -> std::expected<void, std::error_code> {
+                        const std::lock_guard guard{mCore->mutex};
+
+                        if (!waiter.linked)
+                            return std::unexpected{task::Error::CancellationTooLate};
+
+                        mCore->unlink(waiter);
+                        waiter.promise.reject(task::Error::Cancelled);
+                        return {};
+                    }
+                }; !result) {
+                    assert(result.error() == std::errc::operation_canceled);
+                    co_return std::unexpected{ReceiveError::Cancelled};
+                }
+            }
+        }
+
+        void close() {
+            mCore->close();
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return mCore->size.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] bool closed() const {
+            return mCore->closed;
+        }
+
+    private:
+        std::shared_ptr<UnboundedChannelCore<T>> mCore;
+    };
+
+    template<typename T>
+    using UnboundedChannel = std::pair<UnboundedSender<T>, UnboundedReceiver<T>>;
+
+    template<typename T>
+    UnboundedChannel<T> unboundedChannel(std::shared_ptr<EventLoop> eventLoop) {
+        const auto core = std::make_shared<UnboundedChannelCore<T>>(std::move(eventLoop));
+        return {UnboundedSender<T>{core}, UnboundedReceiver<T>{core}};
+    }
+
+    template<typename T>
+    UnboundedChannel<T> unboundedChannel() {
+        return unboundedChannel<T>(getEventLoop());
+    }
+}
+
+#endif //ASYNCIO_UNBOUNDED_CHANNEL_H
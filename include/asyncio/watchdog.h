@@ -0,0 +1,56 @@
+#ifndef ASYNCIO_WATCHDOG_H
+#define ASYNCIO_WATCHDOG_H
+
+#include "event_loop.h"
+#include <list>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace asyncio {
+    // Reports event loops that have not returned to poll within the threshold, from a thread of its own.
+    class Watchdog {
+    public:
+        struct Stall {
+            std::string name;
+            std::chrono::milliseconds duration;
+            // The await the running task resumed from, if it has been resumed at all.
+            std::optional<std::source_location> resumed;
+            // The awaits of the tasks waiting for it, innermost first.
+            std::vector<std::source_location> backtrace;
+
+            [[nodiscard]] std::string trace() const;
+        };
+
+        // Called on the watchdog thread, once per stall.
+        using Sink = std::function<void(const Stall &)>;
+
+        explicit Watchdog(std::chrono::milliseconds threshold, Sink sink = nullptr);
+        Watchdog(const Watchdog &) = delete;
+        Watchdog &operator=(const Watchdog &) = delete;
+        ~Watchdog();
+
+        void watch(EventLoop &eventLoop, std::string name = {});
+
+    private:
+        struct Target {
+            std::string name;
+            std::shared_ptr<Heartbeat> heartbeat;
+            std::uint64_t beats;
+            std::chrono::steady_clock::time_point since;
+            bool reported;
+        };
+
+        [[nodiscard]] std::optional<Stall> check(Target &target, std::chrono::steady_clock::time_point now) const;
+
+        std::chrono::milliseconds mThreshold;
+        Sink mSink;
+        bool mStopped{false};
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::list<Target> mTargets;
+        std::thread mThread;
+    };
+}
+
+#endif //ASYNCIO_WATCHDOG_H
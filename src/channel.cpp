@@ -1,4 +1,5 @@
 #include <asyncio/channel.h>
+#include <asyncio/broadcast_channel.h>
 
 Z_DEFINE_ERROR_CATEGORY_INSTANCES(
     asyncio::TrySendError,
@@ -7,5 +8,8 @@ Z_DEFINE_ERROR_CATEGORY_INSTANCES(
     asyncio::TryReceiveError,
     asyncio::ReceiveSyncError,
     asyncio::ReceiveError,
-    asyncio::ChannelError
+    asyncio::ChannelError,
+    asyncio::BroadcastSendError,
+    asyncio::BroadcastTryReceiveError,
+    asyncio::BroadcastReceiveError
 )
@@ -1,13 +1,200 @@
 #include <asyncio/event_loop.h>
 #include <asyncio/error.h>
 #include <asyncio/task.h>
+#include <asyncio/time.h>
+#include <asyncio/tracer.h>
+#include <zero/defer.h>
+
+constexpr auto CooperativeBudget = std::size_t{128};
 
 thread_local std::weak_ptr<asyncio::EventLoop> threadEventLoop;
+thread_local const uv_loop_t *threadRunningLoop{nullptr};
+thread_local std::size_t threadBudget{CooperativeBudget};
+
+asyncio::EventLoop::TaskQueue::TaskQueue(uv::Handle<uv_async_t> handle)
+    : async{std::move(handle)}, readyQueue{nullptr}, pending{false}, head{&stub}, tail{&stub}, stub{} {
+}
+
+asyncio::EventLoop::TaskQueue::~TaskQueue() {
+    while (const auto node = pop())
+        delete node;
+}
+
+void asyncio::EventLoop::TaskQueue::push(Node *node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    head.exchange(node, std::memory_order_acq_rel)->next.store(node, std::memory_order_release);
+}
+
+asyncio::EventLoop::Node *asyncio::EventLoop::TaskQueue::pop() {
+    auto node = tail;
+    auto next = node->next.load(std::memory_order_acquire);
+
+    if (node == &stub) {
+        if (!next)
+            return nullptr;
+
+        tail = next;
+        node = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return node;
+    }
+
+    /*
+     * A producer has swapped the head but not linked its node yet.
+     * It will set `pending` after linking, so the loop is woken up again and nothing is lost.
+     */
+    if (node != head.load(std::memory_order_acquire))
+        return nullptr;
+
+    push(&stub);
+    next = node->next.load(std::memory_order_acquire);
+
+    if (!next)
+        return nullptr;
+
+    tail = next;
+    return node;
+}
+
+bool asyncio::EventLoop::ReadyQueue::empty() const {
+    return deferred.empty() && std::ranges::all_of(lanes, [](const auto &lane) {
+        return lane.empty();
+    });
+}
+
+/*
+ * An active idle handle keeps the loop alive and makes the next poll non-blocking,
+ * so callables posted outside the poll phase are still drained without waiting for I/O.
+ */
+void asyncio::EventLoop::ReadyQueue::wake() {
+    if (!empty())
+        return;
+
+    zero::error::guard(uv::expected([this] {
+        return uv_idle_start(
+            idle.raw(),
+            [](auto *handle) {
+                static_cast<ReadyQueue *>(handle->data)->drain(false);
+            }
+        );
+    }));
+}
+
+void asyncio::EventLoop::ReadyQueue::push(Callable callable, const Priority priority) {
+    wake();
+    lanes[std::to_underlying(priority)].push_back(std::move(callable));
+}
+
+void asyncio::EventLoop::ReadyQueue::defer(Callable callable) {
+    wake();
+    deferred.emplace_back(std::move(callable), priority);
+}
+
+void asyncio::EventLoop::ReadyQueue::run(Callable callable, const Priority lane) {
+    if (instrumentation) {
+        const auto lag = std::chrono::steady_clock::now() - callable.posted;
+        instrumentation->lag.record(
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(lag).count())
+        );
+    }
+
+    priority = lane;
+    threadBudget = CooperativeBudget;
+    callable.function();
+    task::setOrigin(nullptr);
+
+#ifdef ASYNCIO_CPU_ACCOUNTING
+    task::endSegment();
+#endif
+
+    Tracer::yielded();
+}
+
+void asyncio::EventLoop::ReadyQueue::drain(const bool polled) {
+    // Every round takes a few callables from each lane by weight, so that lower lanes are delayed but never starved.
+    constexpr std::array<std::size_t, 3> weights{16, 4, 1};
+
+    Z_DEFER(priority = Priority::Normal);
+
+    if (instrumentation) {
+        auto queued = deferred.size();
+
+        for (const auto &lane: lanes)
+            queued += lane.size();
+
+        instrumentation->queued.store(queued, std::memory_order_relaxed);
+        instrumentation->depth.record(queued);
+    }
+
+    // Deferred callables only run once the event loop has polled, those deferred from here on wait for the next poll.
+    if (polled) {
+        for (auto &[callable, lane]: std::exchange(deferred, {}))
+            run(std::move(callable), lane);
+    }
+
+    // Callables posted while draining wait for the next drain, so that a task posting itself can not starve I/O.
+    std::array<std::size_t, 3> remaining{};
+
+    for (std::size_t i{0}; i < lanes.size(); ++i)
+        remaining[i] = lanes[i].size();
+
+    while (std::ranges::any_of(remaining, [](const auto count) { return count > 0; })) {
+        for (std::size_t i{0}; i < lanes.size(); ++i) {
+            auto &lane = lanes[i];
+
+            for (std::size_t n{0}; n < weights[i] && remaining[i] > 0; ++n, --remaining[i]) {
+                auto callable = std::move(lane.front());
+                lane.pop_front();
+                run(std::move(callable), static_cast<Priority>(i));
+            }
+        }
+    }
+
+    // The idle handle stays active while anything is left, so the next poll does not block.
+    if (!empty())
+        return;
+
+    zero::error::guard(uv::expected([this] {
+        return uv_idle_stop(idle.raw());
+    }));
+}
 
 asyncio::EventLoop::EventLoop(
     std::unique_ptr<uv_loop_t, void(*)(uv_loop_t *)> loop,
-    std::unique_ptr<TaskQueue> taskQueue
-) : mLoop{std::move(loop)}, mTaskQueue{std::move(taskQueue)} {
+    std::unique_ptr<TaskQueue> taskQueue,
+    std::unique_ptr<ReadyQueue> readyQueue,
+    std::unique_ptr<TimerWheel> timerWheel,
+    std::unique_ptr<Instrumentation> instrumentation
+) : mLoop{std::move(loop)}, mTaskQueue{std::move(taskQueue)}, mReadyQueue{std::move(readyQueue)},
+    mTimerWheel{std::move(timerWheel)}, mInstrumentation{std::move(instrumentation)},
+    mHeartbeat{std::make_shared<Heartbeat>()}, mRegistry{std::make_unique<FrameRegistry>()},
+    mLanes{Lane{this, Priority::High}, Lane{this, Priority::Normal}, Lane{this, Priority::Background}} {
+}
+
+// The lanes point back to the event loop, so they are rebound instead of moved.
+asyncio::EventLoop::EventLoop(EventLoop &&rhs) noexcept
+    : mLoop{std::move(rhs.mLoop)}, mTaskQueue{std::move(rhs.mTaskQueue)}, mReadyQueue{std::move(rhs.mReadyQueue)},
+      mTimerWheel{std::move(rhs.mTimerWheel)}, mInstrumentation{std::move(rhs.mInstrumentation)},
+      mHeartbeat{std::move(rhs.mHeartbeat)}, mPulse{std::move(rhs.mPulse)}, mRegistry{std::move(rhs.mRegistry)},
+      mDetector{std::exchange(rhs.mDetector, nullptr)},
+      mLanes{Lane{this, Priority::High}, Lane{this, Priority::Normal}, Lane{this, Priority::Background}} {
+}
+
+asyncio::EventLoop &asyncio::EventLoop::operator=(EventLoop &&rhs) noexcept {
+    mLoop = std::move(rhs.mLoop);
+    mTaskQueue = std::move(rhs.mTaskQueue);
+    mReadyQueue = std::move(rhs.mReadyQueue);
+    mTimerWheel = std::move(rhs.mTimerWheel);
+    mInstrumentation = std::move(rhs.mInstrumentation);
+    mHeartbeat = std::move(rhs.mHeartbeat);
+    mPulse = std::move(rhs.mPulse);
+    mRegistry = std::move(rhs.mRegistry);
+    mDetector = std::exchange(rhs.mDetector, nullptr);
+    return *this;
 }
 
 asyncio::EventLoop::~EventLoop() {
@@ -15,6 +202,10 @@ asyncio::EventLoop::~EventLoop() {
         return;
 
     mTaskQueue.reset();
+    mReadyQueue.reset();
+    mTimerWheel.reset();
+    mInstrumentation.reset();
+    mPulse.reset();
 
     while (true) {
         if (uv_run(mLoop.get(), UV_RUN_NOWAIT) == 0)
@@ -30,7 +221,7 @@ const uv_loop_t *asyncio::EventLoop::raw() const {
     return mLoop.get();
 }
 
-asyncio::EventLoop asyncio::EventLoop::make() {
+asyncio::EventLoop asyncio::EventLoop::make(const std::chrono::milliseconds timerResolution, const bool metrics) {
     auto loop = std::make_unique<uv_loop_t>();
 
     zero::error::guard(uv::expected([&] {
@@ -44,22 +235,18 @@ asyncio::EventLoop asyncio::EventLoop::make() {
             loop.get(),
             async.get(),
             [](auto *handle) {
-                auto &[h, mutex, queue] = *static_cast<TaskQueue *>(handle->data);
+                auto &taskQueue = *static_cast<TaskQueue *>(handle->data);
 
-                while (true) {
-                    mutex.lock();
+                // Must be cleared before draining, otherwise a concurrent `post` may skip the wakeup and get stuck.
+                taskQueue.pending.exchange(false, std::memory_order_acq_rel);
 
-                    if (queue.empty()) {
-                        mutex.unlock();
-                        break;
-                    }
-
-                    const auto function = std::move(queue.front());
-                    queue.pop();
-                    mutex.unlock();
-
-                    function();
+                // Callables from other threads join the lanes, so that they are ordered by priority as well.
+                while (const auto node = taskQueue.pop()) {
+                    const std::unique_ptr<Node> guard{node};
+                    taskQueue.readyQueue->push(std::move(node->callable), node->priority);
                 }
+
+                taskQueue.readyQueue->drain(false);
             }
         );
     }));
@@ -67,6 +254,84 @@ asyncio::EventLoop asyncio::EventLoop::make() {
     auto taskQueue = std::make_unique<TaskQueue>(uv::Handle{std::move(async)});
     taskQueue->async->data = taskQueue.get();
 
+    auto check = std::make_unique<uv_check_t>();
+
+    zero::error::guard(uv::expected([&] {
+        return uv_check_init(loop.get(), check.get());
+    }));
+
+    auto idle = std::make_unique<uv_idle_t>();
+
+    zero::error::guard(uv::expected([&] {
+        return uv_idle_init(loop.get(), idle.get());
+    }));
+
+    auto readyQueue = std::make_unique<ReadyQueue>(uv::Handle{std::move(check)}, uv::Handle{std::move(idle)});
+    readyQueue->check->data = readyQueue.get();
+    readyQueue->idle->data = readyQueue.get();
+    taskQueue->readyQueue = readyQueue.get();
+
+    // The check handle drains the callables posted by I/O callbacks right after polling, in the same iteration.
+    zero::error::guard(uv::expected([&] {
+        return uv_check_start(
+            readyQueue->check.raw(),
+            [](auto *handle) {
+                static_cast<ReadyQueue *>(handle->data)->drain(true);
+            }
+        );
+    }));
+
+    uv_unref(readyQueue->check.rawHandle());
+
+    auto timer = std::make_unique<uv_timer_t>();
+
+    zero::error::guard(uv::expected([&] {
+        return uv_timer_init(loop.get(), timer.get());
+    }));
+
+    auto timerWheel = std::make_unique<TimerWheel>(uv::Handle{std::move(timer)}, timerResolution);
+
+    std::unique_ptr<Instrumentation> instrumentation;
+
+    if (metrics) {
+        zero::error::guard(uv::expected([&] {
+            return uv_loop_configure(loop.get(), UV_METRICS_IDLE_TIME);
+        }));
+
+        auto prepare = std::make_unique<uv_prepare_t>();
+
+        zero::error::guard(uv::expected([&] {
+            return uv_prepare_init(loop.get(), prepare.get());
+        }));
+
+        instrumentation = std::make_unique<Instrumentation>(uv::Handle{std::move(prepare)});
+        instrumentation->prepare->data = instrumentation.get();
+        readyQueue->instrumentation = instrumentation.get();
+
+        // Runs right before every poll, which marks the boundary between two iterations.
+        zero::error::guard(uv::expected([&] {
+            return uv_prepare_start(
+                instrumentation->prepare.raw(),
+                [](auto *handle) {
+                    auto &inst = *static_cast<Instrumentation *>(handle->data);
+                    const auto now = uv_hrtime();
+
+                    if (inst.previous == 0)
+                        inst.started.store(now, std::memory_order_relaxed);
+                    else
+                        inst.iteration.record((now - inst.previous) / 1000);
+
+                    inst.previous = now;
+                    inst.iterations.store(inst.iterations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    inst.activeHandles.store(handle->loop->active_handles, std::memory_order_relaxed);
+                    inst.activeRequests.store(handle->loop->active_reqs.count, std::memory_order_relaxed);
+                }
+            );
+        }));
+
+        uv_unref(instrumentation->prepare.rawHandle());
+    }
+
     return EventLoop{
         {
             loop.release(),
@@ -77,20 +342,156 @@ asyncio::EventLoop asyncio::EventLoop::make() {
                 delete ptr;
             }
         },
-        std::move(taskQueue)
+        std::move(taskQueue),
+        std::move(readyQueue),
+        std::move(timerWheel),
+        std::move(instrumentation)
     };
 }
 
-// ReSharper disable once CppMemberFunctionMayBeConst
 void asyncio::EventLoop::post(std::function<void()> f) {
-    const std::lock_guard guard{mTaskQueue->mutex};
-    mTaskQueue->queue.push(std::move(f));
+    post(std::move(f), Priority::Normal);
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+void asyncio::EventLoop::post(std::function<void()> f, const Priority priority) {
+    Callable callable{std::move(f)};
+
+    if (mInstrumentation)
+        callable.posted = std::chrono::steady_clock::now();
+
+    if (threadRunningLoop == mLoop.get()) {
+        mReadyQueue->push(std::move(callable), priority);
+        return;
+    }
+
+    mTaskQueue->push(new Node{.callable = std::move(callable), .priority = priority});
+
+    if (mTaskQueue->pending.exchange(true, std::memory_order_acq_rel))
+        return;
 
     zero::error::guard(uv::expected([this] {
         return uv_async_send(mTaskQueue->async.raw());
     }));
 }
 
+// ReSharper disable once CppMemberFunctionMayBeConst
+void asyncio::EventLoop::defer(std::function<void()> f) {
+    if (threadRunningLoop != mLoop.get()) {
+        post(std::move(f));
+        return;
+    }
+
+    Callable callable{std::move(f)};
+
+    if (mInstrumentation)
+        callable.posted = std::chrono::steady_clock::now();
+
+    mReadyQueue->defer(std::move(callable));
+}
+
+asyncio::TimerWheel &asyncio::EventLoop::timerWheel() {
+    return *mTimerWheel;
+}
+
+std::optional<asyncio::EventLoopMetrics> asyncio::EventLoop::metrics() const {
+    if (!mInstrumentation)
+        return std::nullopt;
+
+    const auto &inst = *mInstrumentation;
+    const auto started = inst.started.load(std::memory_order_relaxed);
+
+    return EventLoopMetrics{
+        inst.iterations.load(std::memory_order_relaxed),
+        inst.iteration.snapshot(),
+        inst.lag.snapshot(),
+        inst.depth.snapshot(),
+        inst.queued.load(std::memory_order_relaxed),
+        std::chrono::nanoseconds{started == 0 ? 0 : uv_hrtime() - started},
+        // Guarded by a mutex inside libuv, so it may be read while the event loop is running.
+        std::chrono::nanoseconds{uv_metrics_idle_time(const_cast<uv_loop_t *>(mLoop.get()))},
+        inst.activeHandles.load(std::memory_order_relaxed),
+        inst.activeRequests.load(std::memory_order_relaxed)
+    };
+}
+
+asyncio::Heartbeat &asyncio::EventLoop::heartbeat() const {
+    return *mHeartbeat;
+}
+
+asyncio::FrameRegistry &asyncio::EventLoop::registry() const {
+    return *mRegistry;
+}
+
+asyncio::SlowAwaitDetector *asyncio::EventLoop::detector() const {
+    return mDetector;
+}
+
+void asyncio::EventLoop::setDetector(SlowAwaitDetector *detector) {
+    mDetector = detector;
+}
+
+std::shared_ptr<asyncio::Heartbeat> asyncio::EventLoop::watch() {
+    mHeartbeat->watched.store(true, std::memory_order_relaxed);
+
+    post([this] {
+        if (mPulse)
+            return;
+
+        auto prepare = std::make_unique<uv_prepare_t>();
+
+        zero::error::guard(uv::expected([&] {
+            return uv_prepare_init(mLoop.get(), prepare.get());
+        }));
+
+        auto check = std::make_unique<uv_check_t>();
+
+        zero::error::guard(uv::expected([&] {
+            return uv_check_init(mLoop.get(), check.get());
+        }));
+
+        mPulse = std::make_unique<Pulse>(uv::Handle{std::move(prepare)}, uv::Handle{std::move(check)});
+        mPulse->prepare->data = mHeartbeat.get();
+        mPulse->check->data = mHeartbeat.get();
+
+        // Right before and right after every poll, a stall is a long stretch between the two.
+        zero::error::guard(uv::expected([this] {
+            return uv_prepare_start(
+                mPulse->prepare.raw(),
+                [](auto *handle) {
+                    auto &heartbeat = *static_cast<Heartbeat *>(handle->data);
+                    heartbeat.busy.store(false, std::memory_order_relaxed);
+                    heartbeat.beats.fetch_add(1, std::memory_order_release);
+                }
+            );
+        }));
+
+        zero::error::guard(uv::expected([this] {
+            return uv_check_start(
+                mPulse->check.raw(),
+                [](auto *handle) {
+                    auto &heartbeat = *static_cast<Heartbeat *>(handle->data);
+                    heartbeat.busy.store(true, std::memory_order_relaxed);
+                    heartbeat.beats.fetch_add(1, std::memory_order_release);
+                }
+            );
+        }));
+
+        uv_unref(mPulse->prepare.rawHandle());
+        uv_unref(mPulse->check.rawHandle());
+    });
+
+    return mHeartbeat;
+}
+
+asyncio::Priority asyncio::EventLoop::priority() const {
+    return mReadyQueue->priority;
+}
+
+zero::async::promise::IExecutor *asyncio::EventLoop::lane(const Priority priority) {
+    return &mLanes[std::to_underlying(priority)];
+}
+
 // ReSharper disable once CppMemberFunctionMayBeConst
 void asyncio::EventLoop::stop() {
     uv_stop(mLoop.get());
@@ -98,11 +499,28 @@ void asyncio::EventLoop::stop() {
 
 // ReSharper disable once CppMemberFunctionMayBeConst
 void asyncio::EventLoop::run() {
+    const auto previous = std::exchange(threadRunningLoop, mLoop.get());
+
+    Z_DEFER(
+        threadRunningLoop = previous;
+        mHeartbeat->busy.store(false, std::memory_order_relaxed);
+    );
+
+    mHeartbeat->busy.store(true, std::memory_order_relaxed);
+
     zero::error::guard(uv::expected([this] {
         return uv_run(mLoop.get(), UV_RUN_DEFAULT);
     }));
 }
 
+bool asyncio::consumeBudget() {
+    if (threadBudget == 0)
+        return false;
+
+    --threadBudget;
+    return true;
+}
+
 std::shared_ptr<asyncio::EventLoop> asyncio::getEventLoop() {
     if (threadEventLoop.expired())
         return nullptr;
@@ -115,41 +533,30 @@ void asyncio::setEventLoop(const std::weak_ptr<EventLoop> &eventLoop) {
 }
 
 asyncio::task::Task<void, std::error_code> asyncio::reschedule() {
-    auto ptr = std::make_unique<uv_idle_t>();
+    const auto promise = std::make_shared<Promise<void, std::error_code>>();
 
-    co_await error::guard(uv::expected([&] {
-        return uv_idle_init(getEventLoop()->raw(), ptr.get());
-    }));
-
-    uv::Handle idle{std::move(ptr)};
+    getEventLoop()->defer([=] {
+        if (promise->isFulfilled())
+            return;
 
-    Promise<void, std::error_code> promise;
-    idle->data = &promise;
-
-    co_await error::guard(uv::expected([&] {
-        return uv_idle_start(
-            idle.raw(),
-            [](auto *handle) {
-                zero::error::guard(uv::expected([&] {
-                    return uv_idle_stop(handle);
-                }));
-                static_cast<Promise<void, std::error_code> *>(handle->data)->resolve();
-            }
-        );
-    }));
+        promise->resolve();
+    });
 
     co_return co_await task::Cancellable{
-        promise.getFuture(),
-        [&]() -> std::expected<void, std::error_code> {
-            if (promise.isFulfilled())
+        promise->getFuture(),
+        [=]() -> std::expected<void, std::error_code> {
+            if (promise->isFulfilled())
                 return std::unexpected{task::Error::CancellationTooLate};
 
-            zero::error::guard(uv::expected([&] {
-                return uv_idle_stop(idle.raw());
-            }));
-
-            promise.reject(task::Error::Cancelled);
+            promise->reject(task::Error::Cancelled);
             return {};
         }
     };
 }
+
+double asyncio::EventLoopMetrics::utilisation() const {
+    if (elapsed.count() <= 0)
+        return 0;
+
+    return std::clamp(1 - static_cast<double>(idle.count()) / static_cast<double>(elapsed.count()), 0.0, 1.0);
+}
@@ -0,0 +1,277 @@
+#include <asyncio/event_loop_group.h>
+#include <zero/defer.h>
+#include <deque>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#endif
+
+struct asyncio::EventLoopGroup::Worker {
+    struct Runnable {
+        task::Frame *frame;
+        task::Frame *root;
+        std::coroutine_handle<> handle;
+    };
+
+    Worker(std::shared_ptr<EventLoop> loop, uv::Handle<uv_prepare_t> handle)
+        : eventLoop{std::move(loop)}, prepare{std::move(handle)} {
+    }
+
+    void push(const Runnable runnable) {
+        {
+            const std::lock_guard guard{mutex};
+            queue.push_back(runnable);
+            size.fetch_add(1, std::memory_order_relaxed);
+
+            if (!scheduled) {
+                scheduled = true;
+                eventLoop->post([this] {
+                    drain();
+                });
+            }
+        }
+
+        // Wake up one idle peer, it will try to steal as soon as it gets control.
+        for (const auto &peer: peers) {
+            if (!peer->idle.exchange(false, std::memory_order_acq_rel))
+                continue;
+
+            peer->eventLoop->post([peer] {
+                peer->steal();
+            });
+            break;
+        }
+    }
+
+    std::optional<Runnable> pop() {
+        if (size.load(std::memory_order_relaxed) == 0)
+            return std::nullopt;
+
+        const std::lock_guard guard{mutex};
+
+        if (queue.empty())
+            return std::nullopt;
+
+        const auto runnable = queue.front();
+        queue.pop_front();
+        size.fetch_sub(1, std::memory_order_relaxed);
+
+        return runnable;
+    }
+
+    // Resumes one runnable at a time, so that thieves get the chance to take the rest.
+    void drain() {
+        const auto runnable = pop();
+
+        {
+            const std::lock_guard guard{mutex};
+
+            if (queue.empty())
+                scheduled = false;
+            else
+                eventLoop->post([this] {
+                    drain();
+                });
+        }
+
+        if (runnable)
+            resume(*runnable);
+    }
+
+    void steal() {
+        if (size.load(std::memory_order_relaxed) > 0)
+            return;
+
+        for (const auto &peer: peers) {
+            const auto runnable = peer->pop();
+
+            if (!runnable)
+                continue;
+
+            adopt(*runnable);
+            resume(*runnable);
+            return;
+        }
+
+        idle.store(true, std::memory_order_release);
+    }
+
+    // The frames created from here on count against the root again, until the callable returns.
+    static void resume(const Runnable runnable) {
+        for (auto frame = runnable.frame; frame; frame = frame->parent)
+            frame->attach(frame->eventLoop->registry());
+
+        task::setOrigin(runnable.root);
+        runnable.handle.resume();
+        task::setOrigin(nullptr);
+    }
+
+    // The frames are suspended, but a cancellation may still be touching them on the previous event loop.
+    void adopt(const Runnable runnable) const {
+        const std::lock_guard guard{runnable.root->migration->mutex};
+
+        for (auto frame = runnable.frame; frame; frame = frame->parent)
+            frame->eventLoop = eventLoop;
+
+        runnable.root->migration->eventLoop = eventLoop;
+    }
+
+    std::shared_ptr<EventLoop> eventLoop;
+    uv::Handle<uv_prepare_t> prepare;
+    std::vector<Worker *> peers;
+    std::mutex mutex;
+    std::deque<Runnable> queue;
+    std::atomic<std::size_t> size{0};
+    std::atomic<bool> idle{false};
+    bool scheduled{false};
+};
+
+thread_local asyncio::EventLoopGroup::Worker *threadWorker{nullptr};
+
+asyncio::EventLoopGroup::EventLoopGroup(std::vector<std::shared_ptr<EventLoop>> eventLoops, const bool pinned)
+    : mPinned{pinned}, mEventLoops{std::move(eventLoops)} {
+    for (const auto &eventLoop: mEventLoops) {
+        auto prepare = std::make_unique<uv_prepare_t>();
+
+        zero::error::guard(uv::expected([&] {
+            return uv_prepare_init(eventLoop->raw(), prepare.get());
+        }));
+
+        auto worker = std::make_unique<Worker>(eventLoop, uv::Handle{std::move(prepare)});
+        worker->prepare->data = worker.get();
+
+        // Runs right before the event loop blocks for I/O, which is when it has nothing else to do.
+        zero::error::guard(uv::expected([&] {
+            return uv_prepare_start(
+                worker->prepare.raw(),
+                [](auto *handle) {
+                    static_cast<Worker *>(handle->data)->steal();
+                }
+            );
+        }));
+
+        uv_unref(worker->prepare.rawHandle());
+        mWorkers.push_back(std::move(worker));
+    }
+
+    for (const auto &worker: mWorkers) {
+        for (const auto &peer: mWorkers) {
+            if (peer == worker)
+                continue;
+
+            worker->peers.push_back(peer.get());
+        }
+    }
+}
+
+asyncio::EventLoopGroup::EventLoopGroup(EventLoopGroup &&rhs) noexcept = default;
+
+asyncio::EventLoopGroup::~EventLoopGroup() = default;
+
+asyncio::EventLoopGroup asyncio::EventLoopGroup::make(const std::size_t size, const bool pinned) {
+    std::vector<std::shared_ptr<EventLoop>> eventLoops;
+
+    for (std::size_t i{0}; i < (std::max)(size, std::size_t{1}); ++i)
+        eventLoops.push_back(std::make_shared<EventLoop>(EventLoop::make()));
+
+    return {std::move(eventLoops), pinned};
+}
+
+std::expected<void, std::error_code> asyncio::EventLoopGroup::pin(std::thread &thread, const std::size_t core) {
+#ifdef _WIN32
+    if (!SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{1} << core))
+        return std::unexpected{std::error_code{static_cast<int>(GetLastError()), std::system_category()}};
+
+    return {};
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+
+    if (const auto result = pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set); result != 0)
+        return std::unexpected{std::error_code{result, std::generic_category()}};
+
+    return {};
+#else
+    return std::unexpected{make_error_code(std::errc::operation_not_supported)};
+#endif
+}
+
+std::size_t asyncio::EventLoopGroup::size() const {
+    return mEventLoops.size();
+}
+
+const std::shared_ptr<asyncio::EventLoop> &asyncio::EventLoopGroup::at(const std::size_t index) const {
+    return mEventLoops.at(index);
+}
+
+void asyncio::EventLoopGroup::work(const std::size_t index, const std::function<void()> &function) {
+    const auto previous = std::exchange(threadWorker, mWorkers[index].get());
+    Z_DEFER(threadWorker = previous);
+    function();
+}
+
+std::shared_ptr<asyncio::EventLoop> asyncio::EventLoopGroup::pick() const {
+    for (const auto &worker: mWorkers) {
+        if (worker.get() == threadWorker)
+            return worker->eventLoop;
+    }
+
+    return mEventLoops.front();
+}
+
+namespace {
+    bool offer(asyncio::task::Frame *frame, const std::coroutine_handle<> handle) {
+        // Only a chain of tasks awaiting each other directly, up to a root spawned by the group, can be moved as a whole.
+        auto root = frame;
+        std::size_t members{0};
+
+        for (; root->parent; root = root->parent, ++members) {
+            if (!root->continuation)
+                return false;
+        }
+
+        // Any other frame created under the root is still alive, and shares a non-atomic reference count with the chain.
+        if (!root->migration || root->descendants != members)
+            return false;
+
+        for (auto current = frame; current != root; current = current->parent) {
+            if (current->origin.get() != root)
+                return false;
+        }
+
+        // Left out of every registry until resumed, so that each one is only ever touched by its own thread.
+        for (auto current = frame; current; current = current->parent)
+            current->detach();
+
+        threadWorker->push({frame, root, handle});
+        return true;
+    }
+}
+
+bool asyncio::task::migrate(Frame *frame, const std::coroutine_handle<> handle) {
+    if (!threadWorker)
+        return false;
+
+    if (offer(frame, handle))
+        return true;
+
+    // A task runs eagerly until its caller awaits it, so one started under the root is offered again on the next turn.
+    if (frame->parent || frame->migration || !frame->origin)
+        return false;
+
+    frame->eventLoop->post(
+        [=] {
+            if (offer(frame, handle))
+                return;
+
+            setOrigin(frame->origin.get());
+            handle.resume();
+        },
+        frame->priority
+    );
+
+    return true;
+}
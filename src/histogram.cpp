@@ -0,0 +1,61 @@
+#include <asyncio/histogram.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+double asyncio::HistogramSnapshot::mean() const {
+    if (count == 0)
+        return 0;
+
+    return static_cast<double>(sum) / static_cast<double>(count);
+}
+
+std::uint64_t asyncio::HistogramSnapshot::quantile(const double q) const {
+    if (count == 0)
+        return 0;
+
+    const auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+    std::uint64_t seen{0};
+
+    for (std::size_t i{0}; i < Buckets; ++i) {
+        seen += buckets[i];
+
+        if (seen < (std::max)(rank, std::uint64_t{1}))
+            continue;
+
+        if (i == 0)
+            return 0;
+
+        return (std::min)((std::uint64_t{1} << i) - 1, max);
+    }
+
+    return max;
+}
+
+void asyncio::Histogram::record(const std::uint64_t value) {
+    const auto index = (std::min)(static_cast<std::size_t>(std::bit_width(value)), HistogramSnapshot::Buckets - 1);
+    auto &bucket = mBuckets[index];
+
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    mSum.store(mSum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+
+    if (value > mMax.load(std::memory_order_relaxed))
+        mMax.store(value, std::memory_order_relaxed);
+
+    // Published last, so a reader never sees more samples counted than recorded in the buckets.
+    mCount.store(mCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+asyncio::HistogramSnapshot asyncio::Histogram::snapshot() const {
+    HistogramSnapshot snapshot;
+
+    snapshot.count = mCount.load(std::memory_order_acquire);
+
+    for (std::size_t i{0}; i < HistogramSnapshot::Buckets; ++i)
+        snapshot.buckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+
+    snapshot.sum = mSum.load(std::memory_order_relaxed);
+    snapshot.max = mMax.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
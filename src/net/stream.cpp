@@ -68,7 +68,18 @@ asyncio::net::TCPStream::connect(SocketAddress address) {
         );
     }));
 
-    Z_CO_EXPECT(co_await promise.getFuture());
+    // Closing the handle aborts the pending connect, so that a deadline can cut it short.
+    Z_CO_EXPECT(co_await task::Cancellable{
+        promise.getFuture(),
+        [&]() -> std::expected<void, std::error_code> {
+            if (promise.isFulfilled())
+                return std::unexpected{task::Error::CancellationTooLate};
+
+            tcp.mStream.mStream.close();
+            return {};
+        }
+    });
+
     co_return tcp;
 }
 
@@ -240,7 +251,7 @@ asyncio::net::TCPListener::TCPListener(Listener listener) : mListener{std::move(
 }
 
 std::expected<asyncio::net::TCPListener, std::error_code>
-asyncio::net::TCPListener::listen(const SocketAddress &address) {
+asyncio::net::TCPListener::listen(const SocketAddress &address, const bool reusePort) {
     std::unique_ptr<uv_tcp_t, decltype(&std::free)> tcp{
         static_cast<uv_tcp_t *>(std::malloc(sizeof(uv_tcp_t))),
         std::free
@@ -249,7 +260,11 @@ asyncio::net::TCPListener::listen(const SocketAddress &address) {
     if (!tcp)
         throw zero::error::StacktraceError<std::system_error>{errno, std::generic_category()};
 
+    // The socket must exist before binding, so that the option can be set on it.
     zero::error::guard(uv::expected([&] {
+        if (reusePort)
+            return uv_tcp_init_ex(getEventLoop()->raw(), tcp.get(), address.first->sa_family);
+
         return uv_tcp_init(getEventLoop()->raw(), tcp.get());
     }));
 
@@ -260,6 +275,20 @@ asyncio::net::TCPListener::listen(const SocketAddress &address) {
         }
     };
 
+    if (reusePort) {
+#ifdef _WIN32
+        return std::unexpected{make_error_code(std::errc::operation_not_supported)};
+#else
+        const auto fd = handle.fd();
+        Z_EXPECT(fd);
+
+        Z_EXPECT(zero::os::unix::expected([&] {
+            constexpr int on{1};
+            return setsockopt(*fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+        }));
+#endif
+    }
+
     Z_EXPECT(uv::expected([&] {
         return uv_tcp_bind(reinterpret_cast<uv_tcp_t *>(handle.raw()), address.first.get(), 0);
     }));
@@ -269,6 +298,16 @@ asyncio::net::TCPListener::listen(const SocketAddress &address) {
 
 std::expected<asyncio::net::TCPListener, std::error_code>
 asyncio::net::TCPListener::listen(const std::string &ip, const std::uint16_t port) {
+    return listen(ip, port, false);
+}
+
+std::expected<asyncio::net::TCPListener, std::error_code>
+asyncio::net::TCPListener::listen(const IPAddress &address) {
+    return listen(address, false);
+}
+
+std::expected<asyncio::net::TCPListener, std::error_code>
+asyncio::net::TCPListener::listen(const std::string &ip, const std::uint16_t port, const bool reusePort) {
     const auto address = ipAddressFrom(ip, port);
     Z_EXPECT(address);
 
@@ -280,11 +319,11 @@ asyncio::net::TCPListener::listen(const std::string &ip, const std::uint16_t por
     );
     Z_EXPECT(socketAddress);
 
-    return listen(*std::move(socketAddress));
+    return listen(*std::move(socketAddress), reusePort);
 }
 
 std::expected<asyncio::net::TCPListener, std::error_code>
-asyncio::net::TCPListener::listen(const IPAddress &address) {
+asyncio::net::TCPListener::listen(const IPAddress &address, const bool reusePort) {
     auto socketAddress = std::visit(
         [](const auto &arg) {
             return socketAddressFrom(arg);
@@ -292,7 +331,7 @@ asyncio::net::TCPListener::listen(const IPAddress &address) {
         address
     );
     Z_EXPECT(socketAddress);
-    return listen(*std::move(socketAddress));
+    return listen(*std::move(socketAddress), reusePort);
 }
 
 asyncio::FileDescriptor asyncio::net::TCPListener::fd() const {
@@ -0,0 +1,104 @@
+#include <asyncio/profiler.h>
+#include <fmt/std.h>
+#include <fmt/ranges.h>
+
+namespace {
+    std::string site(const asyncio::task::Frame &frame) {
+        if (!frame.location)
+            return "?";
+
+        const auto &location = *frame.location;
+
+        // Semicolons separate the frames of a folded stack, and may appear in template arguments.
+        auto name = fmt::format("{} ({}:{})", location.function_name(), location.file_name(), location.line());
+        std::ranges::replace(name, ';', ',');
+
+        return name;
+    }
+}
+
+asyncio::Profiler::Profiler(const std::chrono::milliseconds interval)
+    : mEventLoop{getEventLoop()}, mInterval{(std::max)(interval, std::chrono::milliseconds{1})} {
+    mEntry.callback = [this] {
+        sample();
+        mEventLoop->timerWheel().add(mEntry, mInterval);
+    };
+
+    mEventLoop->timerWheel().add(mEntry, mInterval);
+}
+
+asyncio::Profiler::~Profiler() {
+    mEventLoop->timerWheel().remove(mEntry);
+}
+
+std::size_t asyncio::Profiler::samples() const {
+    return mSamples;
+}
+
+std::string asyncio::Profiler::folded() const {
+    std::vector<std::string> lines;
+
+    for (const auto &[stack, hits]: mStacks)
+        lines.push_back(fmt::format("{} {}", stack, hits));
+
+    return to_string(fmt::join(lines, "\n"));
+}
+
+std::vector<std::pair<std::string, std::size_t>> asyncio::Profiler::sites() const {
+    auto sites = mSites | std::ranges::to<std::vector<std::pair<std::string, std::size_t>>>();
+
+    std::ranges::stable_sort(sites, std::ranges::greater{}, [](const auto &pair) {
+        return pair.second;
+    });
+
+    return sites;
+}
+
+// Runs from a timer of the event loop, so every task is suspended and its frames hold still.
+void asyncio::Profiler::sample() {
+    const auto eventLoop = mEventLoop.get();
+
+    // Every frame on the event loop is registered, the ones awaited by no other are the roots.
+    std::vector<const task::Frame *> roots;
+
+    for (auto frame = eventLoop->registry().head; frame; frame = frame->next) {
+        if (frame->parent || frame->finished)
+            continue;
+
+        roots.push_back(frame);
+    }
+
+    ++mSamples;
+
+    std::vector<std::pair<const task::Frame *, std::string>> stack;
+
+    for (const auto &root: roots)
+        stack.emplace_back(root, std::string{});
+
+    while (!stack.empty()) {
+        const auto [frame, prefix] = std::move(stack.back());
+        stack.pop_back();
+
+        if (frame->finished)
+            continue;
+
+        const auto name = site(*frame);
+        auto path = prefix.empty() ? name : fmt::format("{};{}", prefix, name);
+
+        bool leaf{true};
+
+        for (const auto child: frame->awaited()) {
+            if (child->eventLoop.get() != eventLoop || child->finished)
+                continue;
+
+            leaf = false;
+            stack.emplace_back(child, path);
+        }
+
+        if (!leaf)
+            continue;
+
+        ++mStacks[std::move(path)];
+        ++mSites[name];
+    }
+}
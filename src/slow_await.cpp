@@ -0,0 +1,49 @@
+#include <asyncio/slow_await.h>
+#include <fmt/std.h>
+#include <fmt/chrono.h>
+#include <fmt/ranges.h>
+
+std::string asyncio::SlowAwaitDetector::SlowAwait::trace() const {
+    std::vector<std::string> frames;
+
+    for (const auto &site: backtrace | std::views::reverse)
+        frames.push_back(fmt::format("{}{}", std::string(frames.size(), '\t'), site));
+
+    frames.push_back(fmt::format("{}{}", std::string(frames.size(), '\t'), location));
+    return to_string(fmt::join(frames, "\n"));
+}
+
+asyncio::SlowAwaitDetector::SlowAwaitDetector(const std::chrono::nanoseconds threshold, Sink sink)
+    : mEventLoop{getEventLoop()}, mPrevious{mEventLoop->detector()}, mThreshold{threshold}, mSink{std::move(sink)} {
+    if (!mSink) {
+        mSink = [](const SlowAwait &slow) {
+            fmt::print(
+                stderr,
+                "Await took {}\n{}\n",
+                std::chrono::duration_cast<std::chrono::milliseconds>(slow.duration),
+                slow.trace()
+            );
+        };
+    }
+
+    mEventLoop->setDetector(this);
+}
+
+// Detectors are expected to be detached in the reverse order of attaching.
+asyncio::SlowAwaitDetector::~SlowAwaitDetector() {
+    mEventLoop->setDetector(mPrevious);
+}
+
+void asyncio::SlowAwaitDetector::check(const task::Frame &frame, const std::chrono::nanoseconds duration) {
+    if (duration < mThreshold || !frame.location)
+        return;
+
+    SlowAwait slow{duration, *frame.location};
+
+    for (auto parent = frame.parent; parent; parent = parent->parent) {
+        if (parent->location)
+            slow.backtrace.push_back(*parent->location);
+    }
+
+    mSink(slow);
+}
@@ -1,16 +1,328 @@
 #include <asyncio/task.h>
+#include <asyncio/slow_await.h>
+#include <asyncio/tracer.h>
 #include <fmt/std.h>
 #include <fmt/ranges.h>
 #include <stack>
+#include <array>
+#include <atomic>
+
+#ifdef ASYNCIO_CPU_ACCOUNTING
+#include <unordered_map>
+#endif
+
+#ifndef ASYNCIO_DISABLE_FRAME_POOL
+constexpr auto FrameSizeGranularity = std::size_t{64};
+constexpr auto FrameSizeClasses = std::size_t{64};
+constexpr auto FramePoolCapacity = std::size_t{256};
+
+namespace {
+    struct Block {
+        Block *next;
+    };
+
+    struct FramePool {
+        std::array<Block *, FrameSizeClasses> freelists;
+        std::array<std::size_t, FrameSizeClasses> counts;
+        bool released;
+    };
+
+    struct FramePoolReleaser {
+        ~FramePoolReleaser();
+    };
+}
+
+// Trivially destructible, so that frames released by other thread-local objects during thread exit are still handled.
+thread_local constinit FramePool framePool{};
+thread_local FramePoolReleaser framePoolReleaser;
+
+FramePoolReleaser::~FramePoolReleaser() {
+    framePool.released = true;
+
+    for (std::size_t i{0}; i < FrameSizeClasses; ++i) {
+        while (const auto block = framePool.freelists[i]) {
+            framePool.freelists[i] = block->next;
+            ::operator delete(block);
+        }
+
+        framePool.counts[i] = 0;
+    }
+}
+#endif
+
+thread_local constinit asyncio::task::FrameAllocatorStatistics frameStatistics{};
+
+#ifdef ASYNCIO_CPU_ACCOUNTING
+namespace {
+    // Locations of the same await site share the pointer to their file name.
+    struct Site {
+        const char *file;
+        std::uint_least32_t line;
+        std::uint_least32_t column;
+
+        bool operator==(const Site &) const = default;
+    };
+
+    struct SiteHash {
+        std::size_t operator()(const Site &site) const noexcept {
+            return std::hash<const char *>{}(site.file) ^ (std::size_t{site.line} << 16) ^ site.column;
+        }
+    };
+
+    struct Segment {
+        bool open;
+        std::source_location location;
+        std::chrono::steady_clock::time_point start;
+    };
+}
+
+thread_local constinit Segment threadSegment{};
+thread_local std::unordered_map<Site, asyncio::task::CPUTime, SiteHash> threadCPUTime;
+
+namespace {
+    void close(const std::chrono::steady_clock::time_point now) {
+        if (!threadSegment.open)
+            return;
+
+        threadSegment.open = false;
+
+        const auto &location = threadSegment.location;
+        auto &usage = threadCPUTime.try_emplace(
+            Site{location.file_name(), location.line(), location.column()},
+            asyncio::task::CPUTime{location, std::chrono::nanoseconds{0}, 0}
+        ).first->second;
+
+        usage.time += now - threadSegment.start;
+        ++usage.resumes;
+    }
+}
+#endif
+thread_local constinit std::optional<std::chrono::steady_clock::time_point> threadDeadline{};
+thread_local constinit std::uint64_t threadSequence{0};
+constinit std::atomic<std::uint64_t> sequenceRanges{0};
+thread_local constinit asyncio::task::Frame *threadOrigin{nullptr};
+
+void *asyncio::task::allocateFrame(const std::size_t size) {
+    ++frameStatistics.allocations;
+
+#ifndef ASYNCIO_DISABLE_FRAME_POOL
+    if (const auto index = (size - 1) / FrameSizeGranularity; index < FrameSizeClasses) {
+        if (const auto block = framePool.freelists[index]) {
+            framePool.freelists[index] = block->next;
+            --framePool.counts[index];
+            ++frameStatistics.hits;
+            return block;
+        }
+
+        // Round up, so that the block can be reused by any frame of the same size class.
+        return ::operator new((index + 1) * FrameSizeGranularity);
+    }
+#endif
+
+    return ::operator new(size);
+}
+
+void asyncio::task::deallocateFrame(void *ptr, const std::size_t size) noexcept {
+    ++frameStatistics.deallocations;
+
+#ifndef ASYNCIO_DISABLE_FRAME_POOL
+    if (const auto index = (size - 1) / FrameSizeGranularity; index < FrameSizeClasses) {
+        if (framePool.released || framePool.counts[index] >= FramePoolCapacity) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        // Odr-use the releaser, so that cached blocks are freed when the thread exits.
+        static_cast<void>(&framePoolReleaser);
+
+        // Blocks freed on another thread are simply adopted by that thread's pool.
+        framePool.freelists[index] = new(ptr) Block{framePool.freelists[index]};
+        ++framePool.counts[index];
+        return;
+    }
+#endif
+
+    ::operator delete(ptr);
+}
+
+asyncio::task::FrameAllocatorStatistics asyncio::task::frameAllocatorStatistics() {
+    return frameStatistics;
+}
+
+#ifdef ASYNCIO_CPU_ACCOUNTING
+void asyncio::task::beginSegment(const std::optional<std::source_location> &location) {
+    const auto now = std::chrono::steady_clock::now();
+    close(now);
+
+    if (!location)
+        return;
+
+    threadSegment = {true, *location, now};
+}
+
+void asyncio::task::endSegment() {
+    if (!threadSegment.open)
+        return;
+
+    close(std::chrono::steady_clock::now());
+}
+#endif
+
+std::vector<asyncio::task::CPUTime> asyncio::task::cpuTime(const std::size_t n) {
+#ifdef ASYNCIO_CPU_ACCOUNTING
+    auto sites = threadCPUTime | std::views::values | std::ranges::to<std::vector>();
+    const auto middle = sites.begin() + static_cast<std::ptrdiff_t>((std::min)(n, sites.size()));
+
+    std::ranges::partial_sort(sites, middle, std::ranges::greater{}, &CPUTime::time);
+    sites.erase(middle, sites.end());
+
+    return sites;
+#else
+    static_cast<void>(n);
+    return {};
+#endif
+}
+
+void asyncio::task::resetCPUTime() {
+#ifdef ASYNCIO_CPU_ACCOUNTING
+    threadSegment.open = false;
+    threadCPUTime.clear();
+#endif
+}
+
+std::uint64_t asyncio::task::nextFrameSequence() {
+    if (threadSequence == 0)
+        threadSequence = (sequenceRanges.fetch_add(1, std::memory_order_relaxed) + 1) << 40;
+
+    return ++threadSequence;
+}
+
+std::optional<std::chrono::steady_clock::time_point> asyncio::task::takeStartingDeadline() {
+    return std::exchange(threadDeadline, std::nullopt);
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+asyncio::task::exchangeStartingDeadline(const std::optional<std::chrono::steady_clock::time_point> deadline) {
+    return std::exchange(threadDeadline, deadline);
+}
+
+void asyncio::task::setOrigin(Frame *root) {
+    threadOrigin = root;
+}
+
+asyncio::task::Frame::Frame() {
+    Tracer::spawned(*this);
+
+    if (threadOrigin) {
+        origin = FramePtr{threadOrigin};
+        ++threadOrigin->descendants;
+    }
+
+    if (eventLoop)
+        attach(eventLoop->registry());
+}
+
+asyncio::task::Frame::~Frame() {
+    if (origin)
+        --origin->descendants;
+
+    // Parents only go away after resuming, so the frame resumed last is the only one a watchdog could find freed.
+    if (eventLoop) {
+        if (auto &heartbeat = eventLoop->heartbeat(); heartbeat.frame.load(std::memory_order_relaxed) == this) {
+            heartbeat.frame.store(nullptr, std::memory_order_relaxed);
+            heartbeat.steps.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    for (const auto &child: children) {
+        if (child->parent == this)
+            child->parent = nullptr;
+    }
+
+    detach();
+}
+
+void asyncio::task::Frame::attach(FrameRegistry &frames) {
+    assert(!registry);
+
+    registry = &frames;
+    next = std::exchange(frames.head, this);
+
+    if (next)
+        next->prev = this;
+}
+
+void asyncio::task::Frame::detach() {
+    if (!registry)
+        return;
+
+    if (prev)
+        prev->next = next;
+    else
+        registry->head = next;
+
+    if (next)
+        next->prev = prev;
+
+    registry = nullptr;
+    prev = nullptr;
+    next = nullptr;
+}
+
+void asyncio::task::Frame::suspend(const std::source_location &awaited) {
+    location = awaited;
+    Tracer::suspended(*this);
+
+    if (eventLoop && eventLoop->detector())
+        suspended = std::chrono::steady_clock::now();
+}
 
 void asyncio::task::Frame::step() {
+    Tracer::resumed(*this);
+    threadOrigin = migration ? this : origin.get();
+
+    // A single flag is checked unless a watchdog is watching the event loop, the backtrace is only built on a stall.
+    if (auto &heartbeat = eventLoop->heartbeat(); heartbeat.watched.load(std::memory_order_relaxed)) {
+        resumed = location;
+        heartbeat.frame.store(this, std::memory_order_relaxed);
+        heartbeat.steps.fetch_add(1, std::memory_order_release);
+    }
+
+#ifdef ASYNCIO_CPU_ACCOUNTING
+    beginSegment(location);
+#endif
+
+    // The parents are still linked, so the report can tell who was waiting for the slow await.
+    if (suspended) {
+        if (const auto detector = eventLoop->detector())
+            detector->check(*this, std::chrono::steady_clock::now() - *suspended);
+
+        suspended.reset();
+    }
+
+    for (const auto &child: children) {
+        if (child->parent == this)
+            child->parent = nullptr;
+    }
+
     children.clear();
+
+    if (group) {
+        for (const auto &member: group->mFrames) {
+            if (member->parent == this)
+                member->parent = nullptr;
+        }
+
+        group = nullptr;
+    }
+
     location.reset();
     cancel = nullptr;
 }
 
 void asyncio::task::Frame::end() {
     finished = true;
+    Tracer::completed(*this);
 
     for (auto &callback: std::exchange(callbacks, {})) {
         eventLoop->post([callback = std::move(callback)] {
@@ -36,6 +348,7 @@ std::expected<void, std::error_code> asyncio::task::Frame::cancelAll() {
             }
 
             frame->cancelled = true;
+            Tracer::cancelled(*frame);
 
             if (frame->locked) {
                 errors.emplace_back(Error::Locked);
@@ -49,15 +362,17 @@ std::expected<void, std::error_code> asyncio::task::Frame::cancelAll() {
                 break;
             }
 
-            if (frame->children.empty()) {
+            const auto awaited = frame->awaited();
+
+            if (awaited.empty()) {
                 errors.emplace_back(Error::CancellationNotSupported);
                 break;
             }
 
-            for (const auto &f: frame->children | std::views::drop(1) | std::views::reverse)
-                stack.push(f.get());
+            for (const auto &f: awaited | std::views::drop(1) | std::views::reverse)
+                stack.push(f);
 
-            frame = frame->children.front().get();
+            frame = awaited.front();
         }
     }
 
@@ -67,6 +382,21 @@ std::expected<void, std::error_code> asyncio::task::Frame::cancelAll() {
     return {};
 }
 
+std::vector<asyncio::task::Frame *> asyncio::task::Frame::awaited() const {
+    auto frames = children
+        | std::views::transform([](const auto &child) {
+            return child.get();
+        })
+        | std::ranges::to<std::vector>();
+
+    if (group) {
+        for (const auto &member: group->mFrames)
+            frames.push_back(member.get());
+    }
+
+    return frames;
+}
+
 tree<std::source_location> asyncio::task::Frame::callTree() const {
     tree<std::source_location> tr;
     std::stack<std::pair<tree<std::source_location>::iterator, const Frame *>> stack;
@@ -88,13 +418,15 @@ tree<std::source_location> asyncio::task::Frame::callTree() const {
             else
                 it = tr.append_child(it, *frame->location);
 
-            if (frame->children.empty())
+            const auto awaited = frame->awaited();
+
+            if (awaited.empty())
                 break;
 
-            for (const auto &f: frame->children | std::views::drop(1) | std::views::reverse)
-                stack.emplace(it, f.get());
+            for (const auto &f: awaited | std::views::drop(1) | std::views::reverse)
+                stack.emplace(it, f);
 
-            frame = frame->children.front().get();
+            frame = awaited.front();
         }
     }
 
@@ -1,45 +1,321 @@
 #include <asyncio/time.h>
+#include <bit>
+#include <cassert>
 
-asyncio::task::Task<void, std::error_code> asyncio::sleep(const std::chrono::milliseconds ms) {
-    auto ptr = std::make_unique<uv_timer_t>();
+// Entries further out than the wheel can hold are clamped, which is over two years at the default resolution.
+constexpr auto MaxTicks = (std::uint64_t{1} << 6 * asyncio::TimerWheel::Levels) - 1;
 
-    co_await error::guard(uv::expected([&] {
-        return uv_timer_init(getEventLoop()->raw(), ptr.get());
-    }));
+asyncio::TimerWheel::TimerWheel(uv::Handle<uv_timer_t> timer, const std::chrono::milliseconds resolution)
+    : mTimer{std::move(timer)}, mResolution{(std::max)(resolution, std::chrono::milliseconds{1})},
+      mOrigin{uv_now(mTimer->loop)} {
+    mTimer->data = this;
+    uv_unref(mTimer.rawHandle());
+}
 
-    uv::Handle timer{std::move(ptr)};
+std::chrono::milliseconds asyncio::TimerWheel::resolution() const {
+    return mResolution;
+}
 
-    Promise<void, std::error_code> promise;
-    timer->data = &promise;
+std::size_t asyncio::TimerWheel::size() const {
+    return mSize;
+}
+
+void asyncio::TimerWheel::add(Entry &entry, const std::chrono::milliseconds delay) {
+    assert(!entry.pending);
+
+    const auto resolution = static_cast<std::uint64_t>(mResolution.count());
+    const auto now = uv_now(mTimer->loop);
+    const auto expiry = now + static_cast<std::uint64_t>((std::max)(delay.count(), std::int64_t{0}));
+
+    // Nothing is pending, so the wheel can catch up with the clock, and the entry cascades as little as possible.
+    if (mSize == 0)
+        mElapsed = (std::max)(mElapsed, (now - mOrigin) / resolution);
+
+    // Rounded up, a timer never fires early.
+    entry.deadline = std::clamp((expiry - mOrigin + resolution - 1) / resolution, mElapsed + 1, mElapsed + MaxTicks);
+    entry.pending = true;
+
+    insert(entry);
+    ++mSize;
+
+    if (mArmed && *mArmed <= entry.deadline)
+        return;
+
+    arm();
+}
+
+bool asyncio::TimerWheel::remove(Entry &entry) {
+    if (!entry.pending)
+        return false;
+
+    unlink(entry);
+    entry.pending = false;
+    --mSize;
+
+    if (mSize == 0)
+        arm();
+
+    return true;
+}
+
+std::optional<asyncio::TimerWheel::Expiration> asyncio::TimerWheel::next() const {
+    for (std::size_t level{0}; level < Levels; ++level) {
+        if (!mOccupied[level])
+            continue;
+
+        const auto shift = 6 * level;
+        const auto slotRange = std::uint64_t{1} << shift;
+        const auto levelRange = slotRange * Slots;
+
+        const auto current = (mElapsed >> shift) % Slots;
+        const auto slot = (current + std::countr_zero(std::rotr(mOccupied[level], static_cast<int>(current)))) % Slots;
+
+        auto deadline = (mElapsed & ~(levelRange - 1)) + slot * slotRange;
+
+        if (deadline <= mElapsed)
+            deadline += levelRange;
+
+        return Expiration{level, slot, deadline};
+    }
+
+    return std::nullopt;
+}
+
+// The level is picked by the highest bit in which the deadline differs from the elapsed tick.
+void asyncio::TimerWheel::insert(Entry &entry) {
+    const auto significant = std::bit_width((entry.deadline ^ mElapsed) | (Slots - 1)) - 1;
+    const auto level = (std::min)(static_cast<std::size_t>(significant) / 6, Levels - 1);
+    const auto slot = (entry.deadline >> 6 * level) % Slots;
+
+    auto &head = mSlots[level][slot];
+
+    entry.level = level;
+    entry.slot = slot;
+    entry.prev = nullptr;
+    entry.next = head;
+
+    if (head)
+        head->prev = &entry;
+
+    head = &entry;
+    mOccupied[level] |= std::uint64_t{1} << slot;
+}
+
+void asyncio::TimerWheel::unlink(Entry &entry) {
+    // Entries that are due but not fired yet are kept on a separate list, outside of the slots.
+    auto &head = entry.level == Levels ? mFiring : mSlots[entry.level][entry.slot];
+
+    if (entry.prev)
+        entry.prev->next = entry.next;
+    else
+        head = entry.next;
+
+    if (entry.next)
+        entry.next->prev = entry.prev;
+
+    entry.prev = nullptr;
+    entry.next = nullptr;
+
+    if (entry.level < Levels && !head)
+        mOccupied[entry.level] &= ~(std::uint64_t{1} << entry.slot);
+}
+
+void asyncio::TimerWheel::poll() {
+    const auto now = (uv_now(mTimer->loop) - mOrigin) / static_cast<std::uint64_t>(mResolution.count());
+
+    while (true) {
+        const auto expiration = next();
+
+        if (!expiration || expiration->deadline > now)
+            break;
+
+        auto entry = std::exchange(mSlots[expiration->level][expiration->slot], nullptr);
+        mOccupied[expiration->level] &= ~(std::uint64_t{1} << expiration->slot);
+        mElapsed = expiration->deadline;
+
+        // Entries of a higher level cascade down, until they are due.
+        while (entry) {
+            const auto next = entry->next;
+
+            if (entry->deadline > mElapsed) {
+                insert(*entry);
+            }
+            else {
+                entry->level = Levels;
+                entry->prev = nullptr;
+                entry->next = mFiring;
+
+                if (mFiring)
+                    mFiring->prev = entry;
+
+                mFiring = entry;
+            }
+
+            entry = next;
+        }
+    }
+
+    mElapsed = (std::max)(mElapsed, now);
+
+    // A callback may add or remove other entries, including the ones that are about to fire.
+    while (mFiring) {
+        auto &entry = *mFiring;
+
+        unlink(entry);
+        entry.pending = false;
+        --mSize;
+
+        entry.callback();
+    }
 
-    co_await error::guard(uv::expected([&] {
+    arm();
+}
+
+void asyncio::TimerWheel::arm() {
+    const auto expiration = next();
+
+    if (!expiration) {
+        mArmed.reset();
+
+        zero::error::guard(uv::expected([this] {
+            return uv_timer_stop(mTimer.raw());
+        }));
+
+        uv_unref(mTimer.rawHandle());
+        return;
+    }
+
+    const auto resolution = static_cast<std::uint64_t>(mResolution.count());
+    const auto expiry = mOrigin + expiration->deadline * resolution;
+    const auto now = uv_now(mTimer->loop);
+
+    mArmed = expiration->deadline;
+    uv_ref(mTimer.rawHandle());
+
+    zero::error::guard(uv::expected([&] {
         return uv_timer_start(
-            timer.raw(),
+            mTimer.raw(),
             [](auto *handle) {
-                zero::error::guard(uv::expected([&] {
-                    return uv_timer_stop(handle);
-                }));
-                static_cast<Promise<void, std::error_code> *>(handle->data)->resolve();
+                static_cast<TimerWheel *>(handle->data)->poll();
             },
-            ms.count(),
+            expiry > now ? expiry - now : 0,
             0
         );
     }));
+}
+
+asyncio::task::Task<void, std::error_code> asyncio::sleep(const std::chrono::milliseconds ms) {
+    auto &timerWheel = getEventLoop()->timerWheel();
+
+    Promise<void, std::error_code> promise;
+
+    TimerWheel::Entry entry{
+        [&] {
+            promise.resolve();
+        }
+    };
+
+    timerWheel.add(entry, ms);
 
     co_return co_await task::Cancellable{
         promise.getFuture(),
         [&]() -> std::expected<void, std::error_code> {
-            if (promise.isFulfilled())
+            if (!timerWheel.remove(entry))
                 return std::unexpected{task::Error::CancellationTooLate};
 
-            zero::error::guard(uv::expected([&] {
-                return uv_timer_stop(timer.raw());
-            }));
-
             promise.reject(task::Error::Cancelled);
             return {};
         }
     };
 }
 
+asyncio::Interval::Interval(const std::chrono::milliseconds period)
+    : mCore{
+        std::make_shared<Core>(
+            getEventLoop(),
+            (std::max)(period, std::chrono::milliseconds{1}),
+            0,
+            false
+        )
+    } {
+    auto &core = *mCore;
+
+    core.next = uv_now(core.eventLoop->raw()) + core.period.count();
+    core.entry.callback = [&core] {
+        core.ticked = true;
+        schedule(core);
+
+        if (!core.waiter)
+            return;
+
+        std::exchange(core.waiter, std::nullopt)->resolve();
+    };
+
+    schedule(core);
+}
+
+asyncio::Interval &asyncio::Interval::operator=(Interval &&rhs) noexcept {
+    if (this == &rhs)
+        return *this;
+
+    if (mCore)
+        release(*mCore);
+
+    mCore = std::move(rhs.mCore);
+    return *this;
+}
+
+asyncio::Interval::~Interval() {
+    if (!mCore)
+        return;
+
+    release(*mCore);
+}
+
+std::chrono::milliseconds asyncio::Interval::period() const {
+    return mCore->period;
+}
+
+asyncio::task::Task<void, std::error_code> asyncio::Interval::tick() {
+    const auto core = mCore;
+
+    if (std::exchange(core->ticked, false))
+        co_return {};
+
+    assert(!core->waiter);
+    auto future = core->waiter.emplace().getFuture();
+
+    co_return co_await task::Cancellable{
+        std::move(future),
+        [=]() -> std::expected<void, std::error_code> {
+            if (!core->waiter)
+                return std::unexpected{task::Error::CancellationTooLate};
+
+            std::exchange(core->waiter, std::nullopt)->reject(task::Error::Cancelled);
+            return {};
+        }
+    };
+}
+
+// Fixed rate, the next tick is due a whole period after the previous one, skipping the ones already missed.
+void asyncio::Interval::schedule(Core &core) {
+    const auto now = uv_now(core.eventLoop->raw());
+    const auto period = static_cast<std::uint64_t>(core.period.count());
+
+    if (core.next <= now)
+        core.next += ((now - core.next) / period + 1) * period;
+
+    core.eventLoop->timerWheel().add(core.entry, std::chrono::milliseconds{core.next - now});
+}
+
+// The pending tick, if any, is cancelled rather than left waiting for an entry that is gone.
+void asyncio::Interval::release(Core &core) {
+    core.eventLoop->timerWheel().remove(core.entry);
+
+    if (!core.waiter)
+        return;
+
+    std::exchange(core.waiter, std::nullopt)->reject(task::Error::Cancelled);
+}
+
 Z_DEFINE_ERROR_CATEGORY_INSTANCE(asyncio::TimeoutError)
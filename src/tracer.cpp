@@ -0,0 +1,384 @@
+#include <asyncio/tracer.h>
+#include <fmt/format.h>
+#include <zero/defer.h>
+#include <array>
+
+constexpr auto RingCapacity = std::size_t{8192};
+
+namespace {
+    enum class Kind {
+        Spawn,
+        Suspend,
+        Resume,
+        Complete,
+        Cancel,
+        Run,
+        Await
+    };
+
+    // Frames are told apart by their sequence, since the frame pool recycles addresses right away.
+    struct Record {
+        Kind kind;
+        std::uint64_t id;
+        std::chrono::steady_clock::time_point time;
+        std::chrono::nanoseconds duration;
+        std::optional<std::source_location> location;
+    };
+
+    // The task running on the thread since it was resumed.
+    struct Slice {
+        const asyncio::task::Frame *frame;
+        std::uint64_t id;
+        std::chrono::steady_clock::time_point start;
+        std::optional<std::source_location> location;
+    };
+
+    std::string escape(const std::string_view text) {
+        std::string escaped;
+
+        for (const auto c: text) {
+            if (c == '"' || c == '\\') {
+                escaped.push_back('\\');
+                escaped.push_back(c);
+                continue;
+            }
+
+            if (static_cast<unsigned char>(c) < 0x20) {
+                escaped.append(fmt::format("\\u{:04x}", c));
+                continue;
+            }
+
+            escaped.push_back(c);
+        }
+
+        return escaped;
+    }
+
+    std::string site(const std::optional<std::source_location> &location) {
+        if (!location)
+            return "?";
+
+        return fmt::format("{}:{}", escape(location->file_name()), location->line());
+    }
+}
+
+struct asyncio::Tracer::Ring {
+    void push(const Record &record) {
+        const auto position = head.load(std::memory_order_relaxed);
+
+        if (position - tail.load(std::memory_order_acquire) == RingCapacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        records[position % RingCapacity] = record;
+        head.store(position + 1, std::memory_order_release);
+    }
+
+    std::size_t tid;
+    // Only touched by the flushing thread.
+    bool announced{false};
+    std::atomic<std::size_t> dropped{0};
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::array<Record, RingCapacity> records{};
+};
+
+std::atomic<asyncio::Tracer *> activeTracer{nullptr};
+// The generation of the active tracer, or zero, so that threads already registered never touch the tracer itself.
+std::atomic<std::uint64_t> activeGeneration{0};
+std::atomic<std::uint64_t> tracerGenerations{0};
+// Threads registering with the active tracer, which is not destroyed until they are done.
+std::atomic<std::size_t> tracerUsers{0};
+
+thread_local std::shared_ptr<asyncio::Tracer::Ring> threadRing;
+thread_local std::uint64_t threadRingGeneration{0};
+thread_local std::optional<Slice> threadSlice;
+
+namespace {
+    // Slices of a thread never overlap, a frame only closes its own, a resumption closes whichever is open.
+    void close(
+        asyncio::Tracer::Ring &ring,
+        const asyncio::task::Frame *owner,
+        const std::chrono::steady_clock::time_point now
+    ) {
+        if (!threadSlice || (owner && threadSlice->frame != owner))
+            return;
+
+        ring.push({Kind::Run, threadSlice->id, threadSlice->start, now - threadSlice->start, threadSlice->location});
+        threadSlice.reset();
+    }
+}
+
+asyncio::Tracer::Tracer(
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file,
+    const std::chrono::milliseconds interval
+) : mGeneration{tracerGenerations.fetch_add(1, std::memory_order_relaxed) + 1},
+    mEpoch{std::chrono::steady_clock::now()}, mFile{std::move(file)} {
+    mThread = std::thread{
+        [=, this] {
+            std::unique_lock lock{mMutex};
+
+            while (!mCondition.wait_for(lock, interval, [this] { return mStopped; }))
+                flush();
+
+            flush();
+            std::fputs("\n]\n", mFile.get());
+            std::fflush(mFile.get());
+        }
+    };
+
+    activeTracer.store(this, std::memory_order_seq_cst);
+    activeGeneration.store(mGeneration, std::memory_order_release);
+}
+
+asyncio::Tracer::~Tracer() {
+    auto expected = this;
+
+    if (activeTracer.compare_exchange_strong(expected, nullptr, std::memory_order_seq_cst)) {
+        activeGeneration.store(0, std::memory_order_release);
+
+        while (tracerUsers.load(std::memory_order_seq_cst) > 0)
+            std::this_thread::yield();
+    }
+
+    {
+        const std::lock_guard guard{mMutex};
+        mStopped = true;
+    }
+
+    mCondition.notify_one();
+    mThread.join();
+}
+
+std::expected<std::unique_ptr<asyncio::Tracer>, std::error_code>
+asyncio::Tracer::make(const std::filesystem::path &path, const std::chrono::milliseconds interval) {
+    if (activeTracer.load(std::memory_order_acquire))
+        return std::unexpected{make_error_code(std::errc::device_or_resource_busy)};
+
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(path.string().c_str(), "wb"), &std::fclose};
+
+    if (!file)
+        return std::unexpected{std::error_code{errno, std::generic_category()}};
+
+    // The JSON array format, which trace viewers accept even if the closing bracket is missing.
+    std::fputs("[\n", file.get());
+    return std::make_unique<Tracer>(std::move(file), (std::max)(interval, std::chrono::milliseconds{1}));
+}
+
+std::size_t asyncio::Tracer::dropped() const {
+    const std::lock_guard guard{mMutex};
+
+    std::size_t dropped{0};
+
+    for (const auto &ring: mRings)
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+
+    return dropped;
+}
+
+void asyncio::Tracer::spawned(const task::Frame &frame) {
+    const auto ring = current();
+
+    if (!ring)
+        return;
+
+    ring->push({Kind::Spawn, frame.sequence, std::chrono::steady_clock::now(), {}, std::nullopt});
+}
+
+void asyncio::Tracer::suspended(const task::Frame &frame) {
+    const auto ring = current();
+
+    if (!ring)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    close(*ring, &frame, now);
+    ring->push({Kind::Suspend, frame.sequence, now, {}, frame.location});
+
+    // The children being awaited, each gets an arrow from here to the point where it next runs.
+    for (const auto child: frame.awaited()) {
+        if (!child->finished)
+            ring->push({Kind::Await, child->sequence, now, {}, frame.location});
+    }
+}
+
+void asyncio::Tracer::resumed(const task::Frame &frame) {
+    const auto ring = current();
+
+    if (!ring)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    close(*ring, nullptr, now);
+    ring->push({Kind::Resume, frame.sequence, now, {}, frame.location});
+    threadSlice.emplace(&frame, frame.sequence, now, frame.location);
+}
+
+void asyncio::Tracer::completed(const task::Frame &frame) {
+    const auto ring = current();
+
+    if (!ring)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    close(*ring, &frame, now);
+    ring->push({Kind::Complete, frame.sequence, now, {}, std::nullopt});
+}
+
+void asyncio::Tracer::cancelled(const task::Frame &frame) {
+    const auto ring = current();
+
+    if (!ring)
+        return;
+
+    ring->push({Kind::Cancel, frame.sequence, std::chrono::steady_clock::now(), {}, frame.location});
+}
+
+void asyncio::Tracer::yielded() {
+    if (!threadSlice)
+        return;
+
+    const auto ring = current();
+
+    if (!ring) {
+        threadSlice.reset();
+        return;
+    }
+
+    close(*ring, nullptr, std::chrono::steady_clock::now());
+}
+
+asyncio::Tracer::Ring *asyncio::Tracer::current() {
+    const auto generation = activeGeneration.load(std::memory_order_acquire);
+
+    if (generation == 0)
+        return nullptr;
+
+    // The ring is owned by the thread as well, so it outlives a tracer that is being destroyed meanwhile.
+    if (generation == threadRingGeneration)
+        return threadRing.get();
+
+    // Announced before the tracer is loaded, so that its destructor either waits for us or is seen to have run.
+    tracerUsers.fetch_add(1, std::memory_order_seq_cst);
+    Z_DEFER(tracerUsers.fetch_sub(1, std::memory_order_seq_cst));
+
+    const auto tracer = activeTracer.load(std::memory_order_seq_cst);
+
+    if (!tracer)
+        return nullptr;
+
+    const std::lock_guard guard{tracer->mMutex};
+
+    threadRing = std::make_shared<Ring>(tracer->mRings.size());
+    threadRingGeneration = tracer->mGeneration;
+    threadSlice.reset();
+
+    tracer->mRings.push_back(threadRing);
+    return threadRing.get();
+}
+
+// Called by the flushing thread with the mutex held.
+void asyncio::Tracer::flush() {
+    fmt::memory_buffer buffer;
+
+    const auto emit = [&]<typename... Args>(fmt::format_string<Args...> format, Args &&... args) {
+        if (!std::exchange(mFirst, false))
+            buffer.append(std::string_view{",\n"});
+
+        fmt::format_to(std::back_inserter(buffer), format, std::forward<Args>(args)...);
+    };
+
+    const auto timestamp = [this](const std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration<double, std::micro>{time - mEpoch}.count();
+    };
+
+    for (const auto &ring: mRings) {
+        const auto tid = ring->tid;
+
+        if (!std::exchange(ring->announced, true))
+            emit(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"thread {}"}}}})", tid, tid);
+
+        const auto tail = ring->tail.load(std::memory_order_relaxed);
+        const auto head = ring->head.load(std::memory_order_acquire);
+
+        for (auto i = tail; i != head; ++i) {
+            const auto &[kind, id, time, duration, location] = ring->records[i % RingCapacity];
+            const auto ts = timestamp(time);
+
+            switch (kind) {
+            case Kind::Spawn:
+                emit(R"({{"name":"task","cat":"task","ph":"b","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})", id, ts, tid);
+                emit(R"({{"name":"task","cat":"task","ph":"s","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})", id, ts, tid);
+                break;
+
+            case Kind::Suspend:
+            case Kind::Resume:
+            case Kind::Cancel: {
+                constexpr std::array names{"", "suspend", "resume", "", "cancel"};
+
+                emit(
+                    R"({{"name":"{}","cat":"task","ph":"n","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{},"args":{{"location":"{}"}}}})",
+                    names[std::to_underlying(kind)],
+                    id,
+                    ts,
+                    tid,
+                    site(location)
+                );
+
+                if (kind != Kind::Resume)
+                    break;
+
+                // Each resumption is a step of the flow that starts where the task was spawned.
+                emit(R"({{"name":"task","cat":"task","ph":"t","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})", id, ts, tid);
+
+                if (mAwaited.erase(id))
+                    emit(R"({{"name":"await","cat":"await","ph":"f","bp":"e","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})", id, ts, tid);
+
+                break;
+            }
+
+            case Kind::Complete:
+                emit(R"({{"name":"task","cat":"task","ph":"e","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})", id, ts, tid);
+                emit(
+                    R"({{"name":"task","cat":"task","ph":"f","bp":"e","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})",
+                    id,
+                    ts,
+                    tid
+                );
+
+                if (mAwaited.erase(id))
+                    emit(R"({{"name":"await","cat":"await","ph":"f","bp":"e","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})", id, ts, tid);
+
+                break;
+
+            case Kind::Await:
+                // Starts in the slice of the awaiting parent, the id is the child's, where the arrow ends.
+                if (mAwaited.insert(id).second)
+                    emit(R"({{"name":"await","cat":"await","ph":"s","id":"{:#x}","ts":{:.3f},"pid":1,"tid":{}}})", id, ts, tid);
+
+                break;
+
+            case Kind::Run:
+                emit(
+                    R"({{"name":"{}","cat":"task","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{},"args":{{"frame":"{:#x}","location":"{}"}}}})",
+                    location ? escape(location->function_name()) : "task",
+                    ts,
+                    std::chrono::duration<double, std::micro>{duration}.count(),
+                    tid,
+                    id,
+                    site(location)
+                );
+                break;
+            }
+        }
+
+        ring->tail.store(head, std::memory_order_release);
+    }
+
+    std::fwrite(buffer.data(), 1, buffer.size(), mFile.get());
+    std::fflush(mFile.get());
+}
@@ -0,0 +1,118 @@
+#include <asyncio/watchdog.h>
+#include <asyncio/task.h>
+#include <fmt/std.h>
+#include <fmt/chrono.h>
+#include <fmt/ranges.h>
+
+// Bounds the walk, in case the chain was torn by the event loop thread moving on in the middle of it.
+constexpr auto MaxBacktraceDepth = std::size_t{1024};
+
+std::string asyncio::Watchdog::Stall::trace() const {
+    std::vector<std::string> frames;
+
+    for (const auto &location: backtrace | std::views::reverse)
+        frames.push_back(fmt::format("{}{}", std::string(frames.size(), '\t'), location));
+
+    if (resumed)
+        frames.push_back(fmt::format("{}{}", std::string(frames.size(), '\t'), *resumed));
+
+    return to_string(fmt::join(frames, "\n"));
+}
+
+asyncio::Watchdog::Watchdog(const std::chrono::milliseconds threshold, Sink sink)
+    : mThreshold{(std::max)(threshold, std::chrono::milliseconds{1})}, mSink{std::move(sink)} {
+    if (!mSink) {
+        mSink = [](const Stall &stall) {
+            fmt::print(stderr, "Event loop {} stalled for {}\n{}\n", stall.name, stall.duration, stall.trace());
+        };
+    }
+
+    mThread = std::thread{
+        [this] {
+            // Polls a few times per threshold, so a stall is reported at most a quarter late.
+            const auto interval = (std::max)(mThreshold / 4, std::chrono::milliseconds{1});
+
+            std::unique_lock lock{mMutex};
+
+            while (!mCondition.wait_for(lock, interval, [this] { return mStopped; })) {
+                const auto now = std::chrono::steady_clock::now();
+                std::vector<Stall> stalls;
+
+                for (auto &target: mTargets) {
+                    if (auto stall = check(target, now))
+                        stalls.push_back(*std::move(stall));
+                }
+
+                if (stalls.empty())
+                    continue;
+
+                // The sink may watch another event loop or block on one, so it runs without the lock.
+                lock.unlock();
+
+                for (const auto &stall: stalls)
+                    mSink(stall);
+
+                lock.lock();
+            }
+        }
+    };
+}
+
+asyncio::Watchdog::~Watchdog() {
+    {
+        const std::lock_guard guard{mMutex};
+        mStopped = true;
+
+        for (const auto &target: mTargets)
+            target.heartbeat->watched.store(false, std::memory_order_relaxed);
+    }
+
+    mCondition.notify_one();
+    mThread.join();
+}
+
+void asyncio::Watchdog::watch(EventLoop &eventLoop, std::string name) {
+    auto heartbeat = eventLoop.watch();
+    const auto beats = heartbeat->beats.load(std::memory_order_acquire);
+
+    const std::lock_guard guard{mMutex};
+    mTargets.emplace_back(std::move(name), std::move(heartbeat), beats, std::chrono::steady_clock::now(), false);
+}
+
+std::optional<asyncio::Watchdog::Stall>
+asyncio::Watchdog::check(Target &target, const std::chrono::steady_clock::time_point now) const {
+    const auto &heartbeat = *target.heartbeat;
+    const auto beats = heartbeat.beats.load(std::memory_order_acquire);
+
+    if (beats != target.beats || !heartbeat.busy.load(std::memory_order_relaxed)) {
+        target.beats = beats;
+        target.since = now;
+        target.reported = false;
+        return std::nullopt;
+    }
+
+    if (target.reported || now - target.since < mThreshold)
+        return std::nullopt;
+
+    // The frames are read while the event loop thread is stuck, the stall is dropped if it has moved on meanwhile.
+    Stall stall{target.name, std::chrono::duration_cast<std::chrono::milliseconds>(now - target.since)};
+    const auto steps = heartbeat.steps.load(std::memory_order_acquire);
+
+    if (const auto frame = heartbeat.frame.load(std::memory_order_relaxed)) {
+        stall.resumed = frame->resumed;
+
+        for (auto parent = frame->parent; parent && stall.backtrace.size() < MaxBacktraceDepth; parent = parent->parent) {
+            if (parent->location)
+                stall.backtrace.push_back(*parent->location);
+        }
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (heartbeat.steps.load(std::memory_order_relaxed) != steps ||
+        heartbeat.beats.load(std::memory_order_relaxed) != beats)
+        return std::nullopt;
+
+    target.reported = true;
+    return stall;
+}
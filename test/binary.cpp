@@ -1,5 +1,6 @@
 #include "catch_extensions.h"
 #include <asyncio/binary.h>
+#include <asyncio/error.h>
 
 ASYNC_TEMPLATE_TEST_CASE(
     "binary transfer",
@@ -25,4 +26,20 @@ ASYNC_TEMPLATE_TEST_CASE(
         asyncio::BytesReader reader{*std::move(writer)};
         REQUIRE(co_await asyncio::binary::readBE<TestType>(reader) == input);
     }
+
+    SECTION("guard") {
+        asyncio::BytesWriter writer;
+        co_await asyncio::error::guard(asyncio::binary::writeBE(writer, input));
+
+        asyncio::BytesReader reader{*std::move(writer)};
+        REQUIRE(co_await asyncio::error::guard(asyncio::binary::readBE<TestType>(reader)) == input);
+    }
+
+    SECTION("capture") {
+        asyncio::BytesReader reader{std::vector<std::byte>{}};
+        const auto result = co_await asyncio::error::capture(
+            asyncio::error::guard(asyncio::binary::readLE<TestType>(reader))
+        );
+        REQUIRE_FALSE(result);
+    }
 }
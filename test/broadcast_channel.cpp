@@ -0,0 +1,119 @@
+#include "catch_extensions.h"
+#include <asyncio/broadcast_channel.h>
+
+ASYNC_TEST_CASE("broadcast channel", "[channel]") {
+    const auto element = GENERATE(take(1, randomString(1, 1024)));
+
+    auto [sender, receiver] = asyncio::broadcastChannel<std::string>(4);
+
+    SECTION("try receive") {
+        SECTION("success") {
+            REQUIRE(sender.send(element));
+
+            SECTION("closed") {
+                sender.close();
+            }
+
+            const auto result = receiver.tryReceive();
+            REQUIRE(result);
+            REQUIRE(**result == element);
+        }
+
+        SECTION("disconnected") {
+            sender.close();
+            REQUIRE_ERROR(receiver.tryReceive(), asyncio::BroadcastTryReceiveError::Disconnected);
+        }
+
+        SECTION("empty") {
+            REQUIRE_ERROR(receiver.tryReceive(), asyncio::BroadcastTryReceiveError::Empty);
+        }
+    }
+
+    SECTION("receive") {
+        SECTION("wait") {
+            auto task = receiver.receive();
+            REQUIRE_FALSE(task.done());
+
+            REQUIRE(sender.send(element));
+
+            const auto result = co_await task;
+            REQUIRE(result);
+            REQUIRE(**result == element);
+        }
+
+        SECTION("disconnected") {
+            auto task = receiver.receive();
+            sender.close();
+            REQUIRE_ERROR(co_await task, asyncio::BroadcastReceiveError::Disconnected);
+        }
+
+        SECTION("cancel") {
+            auto task = receiver.receive();
+            REQUIRE(task.cancel());
+            REQUIRE_ERROR(co_await task, asyncio::BroadcastReceiveError::Cancelled);
+        }
+    }
+
+    SECTION("shared element") {
+        auto other = sender.subscribe();
+        REQUIRE(sender.receivers() == 2);
+
+        std::array tasks{receiver.receive(), other.receive()};
+        REQUIRE(sender.send(element));
+
+        const auto first = co_await tasks[0];
+        const auto second = co_await tasks[1];
+        REQUIRE(first);
+        REQUIRE(second);
+        REQUIRE(first->get() == second->get());
+    }
+
+    SECTION("subscribe") {
+        REQUIRE(sender.send(element));
+
+        auto other = sender.subscribe();
+        REQUIRE(other.empty());
+        REQUIRE(receiver.size() == 1);
+    }
+
+    SECTION("no receivers") {
+        {
+            [[maybe_unused]] const auto dropped = std::move(receiver);
+        }
+
+        REQUIRE(sender.receivers() == 0);
+        REQUIRE_ERROR(sender.send(element), asyncio::BroadcastSendError::NoReceivers);
+        REQUIRE_FALSE(sender.closed());
+
+        // A later subscriber still gets a working channel.
+        auto other = sender.subscribe();
+        REQUIRE(sender.send(element));
+
+        const auto result = co_await other.receive();
+        REQUIRE(result);
+        REQUIRE(**result == element);
+    }
+
+    SECTION("disconnected") {
+        sender.close();
+        REQUIRE_ERROR(sender.send(element), asyncio::BroadcastSendError::Disconnected);
+    }
+
+    SECTION("lagged") {
+        for (int i{0}; i < 6; ++i) {
+            REQUIRE(sender.send(std::to_string(i)));
+        }
+
+        REQUIRE_ERROR(co_await receiver.receive(), asyncio::BroadcastReceiveError::Lagged);
+        REQUIRE(receiver.lagged() == 2);
+
+        // The sender was never held back, and the receiver resumes from the oldest element still kept.
+        for (int i{2}; i < 6; ++i) {
+            const auto result = co_await receiver.receive();
+            REQUIRE(result);
+            REQUIRE(**result == std::to_string(i));
+        }
+
+        REQUIRE(receiver.empty());
+    }
+}
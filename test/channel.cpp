@@ -579,6 +579,135 @@ ASYNC_TEST_CASE("channel sender dropped", "[channel]") {
     REQUIRE(receiver.closed());
 }
 
+ASYNC_TEST_CASE("channel wakes a single waiter", "[channel]") {
+    const auto element = GENERATE(take(1, randomString(1, 1024)));
+
+    auto [sender, receiver] = asyncio::channel<std::string>(1);
+
+    std::array tasks{receiver.receive(), receiver.receive(), receiver.receive()};
+    REQUIRE(sender.trySend(element));
+
+    REQUIRE(co_await asyncio::reschedule());
+    REQUIRE(std::ranges::count_if(tasks, [](const auto &task) { return task.done(); }) == 1);
+
+    sender.close();
+
+    for (auto &task: tasks) {
+        if (const auto result = co_await task; result)
+            REQUIRE(*result == element);
+        else
+            REQUIRE(result.error() == asyncio::ReceiveError::Disconnected);
+    }
+}
+
+ASYNC_TEST_CASE("channel cross thread wakeups", "[channel]") {
+    const auto times = GENERATE(take(3, random(1, 102400)));
+
+    auto [sender, receiver] = asyncio::channel<int>(1);
+
+    SECTION("receive") {
+        auto task = asyncio::toThread([&, sender = std::move(sender)] mutable {
+            for (int i{0}; i < times; ++i)
+                zero::error::guard(sender.sendSync(i));
+        });
+
+        for (int i{0}; i < times; ++i) {
+            REQUIRE(co_await receiver.receive() == i);
+        }
+
+        REQUIRE_NOTHROW(co_await task);
+        REQUIRE_ERROR(co_await receiver.receive(), asyncio::ReceiveError::Disconnected);
+    }
+
+    SECTION("send") {
+        auto task = asyncio::toThread([&, receiver = std::move(receiver)] mutable {
+            for (int i{0}; i < times; ++i) {
+                if (zero::error::guard(receiver.receiveSync()) != i)
+                    throw zero::error::StacktraceError<std::runtime_error>{"Received incorrect element"};
+            }
+        });
+
+        for (int i{0}; i < times; ++i) {
+            REQUIRE(co_await sender.send(i));
+        }
+
+        REQUIRE_NOTHROW(co_await task);
+    }
+}
+
+ASYNC_TEST_CASE("channel batch", "[channel]") {
+    auto [sender, receiver] = asyncio::channel<int>(4);
+
+    SECTION("send many") {
+        SECTION("fill free slots") {
+            std::array elements{1, 2, 3, 4, 5, 6};
+            REQUIRE(co_await sender.sendMany(elements) == 4);
+            REQUIRE(sender.full());
+        }
+
+        SECTION("wait") {
+            std::array elements{1, 2, 3, 4};
+            REQUIRE(co_await sender.sendMany(elements) == 4);
+
+            auto task = sender.sendMany(std::span{elements}.first(2));
+            REQUIRE_FALSE(task.done());
+
+            REQUIRE(receiver.tryReceive() == 1);
+            REQUIRE(co_await task == 1);
+        }
+
+        SECTION("disconnected") {
+            std::array elements{1, 2};
+            sender.close();
+            REQUIRE_ERROR(co_await sender.sendMany(elements), asyncio::SendError::Disconnected);
+        }
+
+        SECTION("cancelled") {
+            std::array elements{1, 2, 3, 4};
+            REQUIRE(co_await sender.sendMany(elements) == 4);
+
+            std::array rest{5};
+            auto task = sender.sendMany(rest);
+            REQUIRE(task.cancel());
+            REQUIRE_ERROR(co_await task, asyncio::SendError::Cancelled);
+            REQUIRE(rest[0] == 5);
+        }
+    }
+
+    SECTION("receive many") {
+        SECTION("span") {
+            REQUIRE(sender.trySend(1));
+            REQUIRE(sender.trySend(2));
+            REQUIRE(sender.trySend(3));
+
+            std::array<int, 2> elements{};
+            REQUIRE(co_await receiver.receiveMany(elements) == 2);
+            REQUIRE(elements == std::array{1, 2});
+            REQUIRE(receiver.size() == 1);
+        }
+
+        SECTION("vector") {
+            auto task = receiver.receiveMany(8);
+            REQUIRE_FALSE(task.done());
+
+            std::array elements{1, 2, 3};
+            REQUIRE(co_await sender.sendMany(elements) == 3);
+            REQUIRE(co_await task == std::vector{1, 2, 3});
+        }
+
+        SECTION("disconnected") {
+            sender.close();
+            REQUIRE_ERROR(co_await receiver.receiveMany(8), asyncio::ReceiveError::Disconnected);
+        }
+
+        SECTION("cancelled") {
+            auto task = receiver.receiveMany(8);
+            REQUIRE(task.cancel());
+            REQUIRE_ERROR(co_await task, asyncio::ReceiveError::Cancelled);
+        }
+    }
+}
+
 ASYNC_TEST_CASE("channel concurrency testing", "[channel]") {
     const auto capacity = GENERATE(take(5, random(1uz, 1024uz)));
     const auto element = GENERATE(take(1, randomString(1, 1024)));
@@ -1,6 +1,9 @@
 #include "catch_extensions.h"
 #include <asyncio/event_loop.h>
 #include <asyncio/error.h>
+#include <asyncio/time.h>
+#include <thread>
+#include <list>
 
 TEST_CASE("event loop", "[event loop]") {
     SECTION("with error") {
@@ -46,3 +49,212 @@ TEST_CASE("event loop", "[event loop]") {
         }
     }
 }
+
+ASYNC_TEST_CASE("post from multiple threads", "[event loop]") {
+    constexpr std::size_t producers{4};
+    constexpr std::size_t count{10000};
+
+    const auto eventLoop = asyncio::getEventLoop();
+
+    std::size_t counter{0};
+    asyncio::Promise<void> promise;
+
+    std::list<std::thread> threads;
+
+    for (std::size_t i{0}; i < producers; ++i) {
+        threads.emplace_back([&] {
+            for (std::size_t j{0}; j < count; ++j) {
+                eventLoop->post([&] {
+                    if (++counter == producers * count)
+                        promise.resolve();
+                });
+            }
+        });
+    }
+
+    co_await promise.getFuture();
+
+    for (auto &thread: threads)
+        thread.join();
+
+    REQUIRE(counter == producers * count);
+}
+
+ASYNC_TEST_CASE("post from event loop thread", "[event loop]") {
+    const auto eventLoop = asyncio::getEventLoop();
+
+    std::vector<int> sequence;
+    asyncio::Promise<void> promise;
+
+    eventLoop->post([&] {
+        sequence.push_back(1);
+
+        eventLoop->post([&] {
+            sequence.push_back(3);
+            promise.resolve();
+        });
+
+        sequence.push_back(2);
+    });
+
+    REQUIRE(sequence.empty());
+
+    co_await promise.getFuture();
+    REQUIRE(sequence == std::vector{1, 2, 3});
+}
+
+ASYNC_TEST_CASE("post with priority", "[event loop]") {
+    const auto eventLoop = asyncio::getEventLoop();
+
+    std::vector<asyncio::Priority> sequence;
+    asyncio::Promise<void> promise;
+
+    for (int i{0}; i < 8; ++i) {
+        eventLoop->post(
+            [&] {
+                sequence.push_back(asyncio::Priority::Background);
+            },
+            asyncio::Priority::Background
+        );
+
+        eventLoop->post(
+            [&] {
+                sequence.push_back(asyncio::Priority::Normal);
+            },
+            asyncio::Priority::Normal
+        );
+    }
+
+    eventLoop->post(
+        [&] {
+            sequence.push_back(asyncio::Priority::High);
+        },
+        asyncio::Priority::High
+    );
+
+    eventLoop->post(
+        [&] {
+            promise.resolve();
+        },
+        asyncio::Priority::Background
+    );
+
+    co_await promise.getFuture();
+    REQUIRE(sequence.size() == 17);
+    REQUIRE(sequence[0] == asyncio::Priority::High);
+    // The background lane is not starved by the normal one.
+    REQUIRE(sequence[5] == asyncio::Priority::Background);
+    REQUIRE(sequence.back() == asyncio::Priority::Background);
+}
+
+ASYNC_TEST_CASE("inherit task priority", "[event loop]") {
+    co_await asyncio::task::prioritize(asyncio::Priority::High);
+    REQUIRE(asyncio::getEventLoop()->priority() == asyncio::Priority::High);
+
+    const auto priority = co_await []() -> asyncio::task::Task<asyncio::Priority> {
+        co_await asyncio::error::guard(asyncio::reschedule());
+        co_return asyncio::getEventLoop()->priority();
+    }();
+    REQUIRE(priority == asyncio::Priority::High);
+
+    SECTION("call tree") {
+        auto task = []() -> asyncio::task::Task<void> {
+            co_await asyncio::task::prioritize(asyncio::Priority::Background);
+        }();
+        REQUIRE(task.callTree().size() == 1);
+        REQUIRE(task.cancel());
+
+        co_await task;
+        REQUIRE(task.done());
+    }
+}
+
+ASYNC_TEST_CASE("cooperative budget", "[event loop]") {
+    bool posted{false};
+
+    asyncio::getEventLoop()->post([&] {
+        posted = true;
+    });
+
+    // Without yielding, the posted callable would never get the chance to run.
+    std::size_t iterations{0};
+
+    while (!posted) {
+        co_await asyncio::Future<void>::resolved();
+        ++iterations;
+    }
+
+    REQUIRE(iterations <= 128);
+}
+
+ASYNC_TEST_CASE("callable posting itself does not starve timers", "[event loop]") {
+    using namespace std::chrono_literals;
+
+    const auto eventLoop = asyncio::getEventLoop();
+
+    bool stopped{false};
+    std::size_t count{0};
+
+    std::function<void()> repost = [&] {
+        if (stopped)
+            return;
+
+        ++count;
+        eventLoop->post(repost);
+    };
+
+    eventLoop->post(repost);
+
+    // Each drain only runs what was queued when it started, so the timer still fires.
+    REQUIRE(co_await asyncio::sleep(10ms));
+    stopped = true;
+    REQUIRE(count > 0);
+}
+
+TEST_CASE("event loop metrics", "[event loop]") {
+    using namespace std::chrono_literals;
+
+    SECTION("disabled") {
+        REQUIRE_FALSE(asyncio::EventLoop::make().metrics());
+    }
+
+    SECTION("enabled") {
+        const auto eventLoop = std::make_shared<asyncio::EventLoop>(asyncio::EventLoop::make(1ms, true));
+
+        const auto result = asyncio::run(eventLoop, []() -> asyncio::task::Task<void> {
+            for (int i{0}; i < 10; ++i) {
+                co_await asyncio::error::guard(asyncio::sleep(5ms));
+                co_await asyncio::error::guard(asyncio::reschedule());
+            }
+        });
+        REQUIRE(result);
+
+        const auto metrics = eventLoop->metrics();
+        REQUIRE(metrics);
+        REQUIRE(metrics->iterations >= 10);
+        REQUIRE(metrics->iteration.count > 0);
+        REQUIRE(metrics->lag.count > 0);
+        REQUIRE(metrics->depth.count > 0);
+        REQUIRE(metrics->idle >= 40ms);
+        REQUIRE(metrics->elapsed >= metrics->idle);
+        REQUIRE(metrics->utilisation() >= 0);
+        REQUIRE(metrics->utilisation() < 1);
+    }
+}
+
+TEST_CASE("histogram", "[event loop]") {
+    asyncio::Histogram histogram;
+
+    for (std::uint64_t i{0}; i < 100; ++i)
+        histogram.record(i);
+
+    const auto snapshot = histogram.snapshot();
+    REQUIRE(snapshot.count == 100);
+    REQUIRE(snapshot.sum == 4950);
+    REQUIRE(snapshot.max == 99);
+    REQUIRE(snapshot.mean() == 49.5);
+    REQUIRE(snapshot.buckets[0] == 1);
+    REQUIRE(snapshot.buckets[7] == 36);
+    REQUIRE(snapshot.quantile(0.5) == 63);
+    REQUIRE(snapshot.quantile(1) == 99);
+}
@@ -0,0 +1,156 @@
+#include "catch_extensions.h"
+#include <asyncio/event_loop_group.h>
+#include <asyncio/time.h>
+#include <asyncio/error.h>
+#include <set>
+
+TEST_CASE("event loop group", "[event loop group]") {
+    auto group = asyncio::EventLoopGroup::make(4);
+    REQUIRE(group.size() == 4);
+
+    SECTION("run") {
+        const auto results = group.run([](const std::size_t index) -> asyncio::task::Task<std::size_t> {
+            co_await asyncio::sleep(std::chrono::milliseconds{10});
+            co_return index * 2;
+        });
+        REQUIRE(results.size() == 4);
+
+        for (std::size_t i{0}; i < results.size(); ++i) {
+            REQUIRE(results[i]);
+            REQUIRE(*results[i] == i * 2);
+        }
+    }
+
+    SECTION("spawn on another event loop") {
+        asyncio::Promise<void> promise;
+
+        const auto results = group.run(
+            [&](const std::size_t index) -> asyncio::task::Task<std::thread::id, std::error_code> {
+                if (index != 0) {
+                    co_await promise.getFuture();
+                    co_return std::this_thread::get_id();
+                }
+
+                const auto id = co_await asyncio::spawnOn(
+                    group,
+                    1,
+                    []() -> asyncio::task::Task<std::thread::id, std::error_code> {
+                        co_return std::this_thread::get_id();
+                    }
+                );
+                promise.resolve();
+                co_return id;
+            }
+        );
+        REQUIRE(results.size() == 4);
+        REQUIRE(results[0]);
+        REQUIRE(results[1]);
+        REQUIRE(*results[0] == *results[1]);
+    }
+
+    SECTION("cancel task spawned on another event loop") {
+        asyncio::Promise<void> promise;
+
+        const auto results = group.run([&](const std::size_t index) -> asyncio::task::Task<void, std::error_code> {
+            if (index != 0) {
+                co_await promise.getFuture();
+                co_return {};
+            }
+
+            auto task = asyncio::spawnOn(group, 1, [] {
+                return asyncio::sleep(std::chrono::hours{1});
+            });
+            Z_CO_EXPECT(task.cancel());
+
+            const auto result = co_await task;
+            promise.resolve();
+            co_return result;
+        });
+        REQUIRE(results.size() == 4);
+        REQUIRE_FALSE(results[0]);
+        REQUIRE(results[0].error() == std::errc::operation_canceled);
+    }
+
+    SECTION("steal migratable tasks") {
+        asyncio::Promise<void> promise;
+
+        const auto results = group.run(
+            [&](const std::size_t index) -> asyncio::task::Task<std::vector<std::thread::id>, std::error_code> {
+                if (index != 0) {
+                    co_await promise.getFuture();
+                    co_return {};
+                }
+
+                std::vector<asyncio::task::Task<std::thread::id, std::error_code>> tasks;
+
+                for (int i{0}; i < 16; ++i) {
+                    tasks.push_back(group.submit([]() -> asyncio::task::Task<std::thread::id, std::error_code> {
+                        co_await asyncio::task::migratable;
+                        // Simulates a CPU-bound job that would otherwise keep the first event loop hot.
+                        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                        co_return std::this_thread::get_id();
+                    }));
+                }
+
+                auto ids = co_await asyncio::task::all(tasks);
+                promise.resolve();
+                co_return ids;
+            }
+        );
+        REQUIRE(results.size() == 4);
+        REQUIRE(results[0]);
+        REQUIRE(results[0]->size() == 16);
+        REQUIRE(std::set(results[0]->begin(), results[0]->end()).size() > 1);
+    }
+
+    SECTION("live child pins a migratable task") {
+        asyncio::Promise<void> promise;
+
+        const auto results = group.run(
+            [&](const std::size_t index) -> asyncio::task::Task<std::vector<bool>, std::error_code> {
+                if (index != 0) {
+                    co_await promise.getFuture();
+                    co_return {};
+                }
+
+                std::vector<asyncio::task::Task<bool, std::error_code>> tasks;
+
+                for (int i{0}; i < 16; ++i) {
+                    tasks.push_back(group.submit([]() -> asyncio::task::Task<bool, std::error_code> {
+                        const auto id = std::this_thread::get_id();
+                        auto child = asyncio::sleep(std::chrono::milliseconds{50});
+
+                        // The child is still owned by this event loop, so the task must not move away from it.
+                        co_await asyncio::task::migratable;
+                        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                        const auto pinned = std::this_thread::get_id() == id;
+
+                        Z_CO_EXPECT(co_await child);
+                        co_return pinned;
+                    }));
+                }
+
+                auto pinned = co_await asyncio::task::all(tasks);
+                promise.resolve();
+                co_return pinned;
+            }
+        );
+        REQUIRE(results.size() == 4);
+        REQUIRE(results[0]);
+        REQUIRE(std::ranges::all_of(*results[0], std::identity{}));
+    }
+
+    SECTION("migratable outside of a spawned task") {
+        const auto results = group.run([](const std::size_t) -> asyncio::task::Task<bool> {
+            const auto id = std::this_thread::get_id();
+            co_await asyncio::task::migratable;
+            co_return std::this_thread::get_id() == id;
+        });
+        REQUIRE(results.size() == 4);
+
+        for (const auto &result: results) {
+            REQUIRE(result);
+            REQUIRE(*result);
+        }
+    }
+}
@@ -101,6 +101,17 @@ ASYNC_TEST_CASE("TCP stream", "[net::tcp]") {
     }
 }
 
+#ifdef __linux__
+ASYNC_TEST_CASE("TCP listener with SO_REUSEPORT", "[net::tcp]") {
+    auto listener = co_await asyncio::error::guard(asyncio::net::TCPListener::listen("127.0.0.1", 0, true));
+    const auto address = co_await asyncio::error::guard(listener.address());
+
+    const auto other = asyncio::net::TCPListener::listen(address, true);
+    REQUIRE(other);
+    REQUIRE(other->address() == address);
+}
+#endif
+
 #ifdef _WIN32
 ASYNC_TEST_CASE("named pipe stream", "[net]") {
     const auto name = fmt::format(R"(\\.\pipe\asyncio-{})", GENERATE(take(1, randomAlphanumericString(8, 16))));
@@ -0,0 +1,41 @@
+#include "catch_extensions.h"
+#include <asyncio/profiler.h>
+
+ASYNC_TEST_CASE("profiler", "[profiler]") {
+    using namespace std::chrono_literals;
+
+    asyncio::Profiler profiler{5ms};
+    co_await asyncio::error::guard(asyncio::sleep(100ms));
+
+    REQUIRE(profiler.samples() >= 10);
+
+    const auto sites = profiler.sites();
+    REQUIRE(sites.size() == 1);
+    REQUIRE(sites.front().first.contains("sleep"));
+    REQUIRE(sites.front().second == profiler.samples());
+
+    // The sleeping task, under the test created before profiling started.
+    const auto folded = profiler.folded();
+    REQUIRE(folded.contains(';'));
+    REQUIRE(folded.ends_with(fmt::format(" {}", profiler.samples())));
+}
+
+ASYNC_TEST_CASE("profiler samples tasks created before it", "[profiler]") {
+    using namespace std::chrono_literals;
+
+    asyncio::Promise<void, std::error_code> promise;
+    auto task = asyncio::task::from(promise.getFuture());
+
+    {
+        asyncio::Profiler profiler{5ms};
+        co_await asyncio::error::guard(asyncio::sleep(50ms));
+
+        // Waiting on its own, not awaited by the sleeping test.
+        REQUIRE(std::ranges::any_of(profiler.sites(), [](const auto &site) {
+            return site.first.contains("from");
+        }));
+    }
+
+    promise.resolve();
+    REQUIRE(co_await task);
+}
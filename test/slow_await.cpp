@@ -0,0 +1,37 @@
+#include "catch_extensions.h"
+#include <asyncio/slow_await.h>
+#include <asyncio/time.h>
+
+TEST_CASE("slow await detector", "[slow await]") {
+    using namespace std::chrono_literals;
+
+    std::vector<asyncio::SlowAwaitDetector::SlowAwait> awaits;
+    std::uint_least32_t line{};
+
+    const auto result = asyncio::run([&]() -> asyncio::task::Task<void, std::error_code> {
+        asyncio::SlowAwaitDetector detector{
+            50ms,
+            [&](const auto &slow) {
+                awaits.push_back(slow);
+            }
+        };
+
+        Z_CO_EXPECT(co_await asyncio::sleep(1ms));
+
+        co_return co_await [&]() -> asyncio::task::Task<void, std::error_code> {
+            line = std::source_location::current().line() + 1;
+            co_return co_await asyncio::sleep(100ms);
+        }();
+    });
+    REQUIRE(result);
+
+    // The timer inside `sleep` is reported first, then every task that was waiting for it.
+    REQUIRE(awaits.size() == 3);
+    REQUIRE(awaits[0].duration >= 50ms);
+    REQUIRE(awaits[0].backtrace.size() == 2);
+    REQUIRE(awaits[0].backtrace[0].line() == line);
+    REQUIRE(awaits[1].location.line() == line);
+    REQUIRE(awaits[1].backtrace.size() == 1);
+    REQUIRE(awaits[2].backtrace.empty());
+    REQUIRE_FALSE(awaits[0].trace().empty());
+}
@@ -0,0 +1,182 @@
+#include "catch_extensions.h"
+#include <asyncio/spsc_channel.h>
+#include <asyncio/thread.h>
+
+ASYNC_TEST_CASE("spsc channel sender", "[channel]") {
+    const auto capacity = GENERATE(1uz, take(1, random(2uz, 1024uz)));
+    const auto element = GENERATE(take(1, randomString(1, 1024)));
+
+    auto [sender, receiver] = asyncio::spscChannel<std::string>(capacity);
+
+    SECTION("try send") {
+        SECTION("success") {
+            REQUIRE(sender.trySend(element));
+            REQUIRE(sender.size() == 1);
+        }
+
+        SECTION("disconnected") {
+            receiver.close();
+            REQUIRE_ERROR(sender.trySend(element), asyncio::TrySendError::Disconnected);
+        }
+
+        SECTION("full") {
+            for (std::size_t i{0}; i < capacity; ++i) {
+                REQUIRE(sender.trySend(element));
+            }
+
+            REQUIRE(sender.full());
+            REQUIRE_ERROR(sender.trySend(element), asyncio::TrySendError::Full);
+        }
+    }
+
+    SECTION("send sync") {
+        SECTION("wait") {
+            for (std::size_t i{0}; i < capacity; ++i) {
+                REQUIRE(sender.trySend(element));
+            }
+
+            auto task = asyncio::toThread([&] {
+                return sender.sendSync(element);
+            });
+
+            REQUIRE(receiver.tryReceive() == element);
+            REQUIRE(co_await task);
+        }
+
+        SECTION("timeout") {
+            using namespace std::chrono_literals;
+
+            for (std::size_t i{0}; i < capacity; ++i) {
+                REQUIRE(sender.trySend(element));
+            }
+
+            REQUIRE_ERROR(sender.sendSync(element, 10ms), asyncio::SendSyncError::Timeout);
+        }
+    }
+
+    SECTION("send") {
+        SECTION("no wait") {
+            REQUIRE(co_await sender.send(element));
+        }
+
+        SECTION("wait") {
+            for (std::size_t i{0}; i < capacity; ++i) {
+                REQUIRE(sender.trySend(element));
+            }
+
+            auto task = sender.send(element);
+            REQUIRE_FALSE(task.done());
+
+            REQUIRE(receiver.tryReceive() == element);
+            REQUIRE(co_await task);
+        }
+
+        SECTION("disconnected") {
+            for (std::size_t i{0}; i < capacity; ++i) {
+                REQUIRE(sender.trySend(element));
+            }
+
+            auto task = sender.send(element);
+            receiver.close();
+            REQUIRE_ERROR(co_await task, asyncio::SendError::Disconnected);
+        }
+
+        SECTION("cancel") {
+            for (std::size_t i{0}; i < capacity; ++i) {
+                REQUIRE(sender.trySend(element));
+            }
+
+            auto task = sender.send(element);
+            REQUIRE(task.cancel());
+            REQUIRE_ERROR(co_await task, asyncio::SendError::Cancelled);
+        }
+    }
+}
+
+ASYNC_TEST_CASE("spsc channel receiver", "[channel]") {
+    const auto capacity = GENERATE(1uz, take(1, random(2uz, 1024uz)));
+    const auto element = GENERATE(take(1, randomString(1, 1024)));
+
+    auto [sender, receiver] = asyncio::spscChannel<std::string>(capacity);
+
+    SECTION("try receive") {
+        SECTION("success") {
+            REQUIRE(sender.trySend(element));
+
+            SECTION("closed") {
+                sender.close();
+            }
+
+            REQUIRE(receiver.tryReceive() == element);
+        }
+
+        SECTION("disconnected") {
+            sender.close();
+            REQUIRE_ERROR(receiver.tryReceive(), asyncio::TryReceiveError::Disconnected);
+        }
+
+        SECTION("empty") {
+            REQUIRE_ERROR(receiver.tryReceive(), asyncio::TryReceiveError::Empty);
+        }
+    }
+
+    SECTION("receive sync") {
+        SECTION("wait") {
+            auto task = asyncio::toThread([&] {
+                return receiver.receiveSync();
+            });
+
+            REQUIRE(sender.trySend(element));
+            REQUIRE(co_await task == element);
+        }
+
+        SECTION("timeout") {
+            using namespace std::chrono_literals;
+            REQUIRE_ERROR(receiver.receiveSync(10ms), asyncio::ReceiveSyncError::Timeout);
+        }
+    }
+
+    SECTION("receive") {
+        SECTION("wait") {
+            auto task = receiver.receive();
+            REQUIRE_FALSE(task.done());
+
+            REQUIRE(sender.trySend(element));
+            REQUIRE(co_await task == element);
+        }
+
+        SECTION("disconnected") {
+            auto task = receiver.receive();
+            sender.close();
+            REQUIRE_ERROR(co_await task, asyncio::ReceiveError::Disconnected);
+        }
+
+        SECTION("cancel") {
+            auto task = receiver.receive();
+            REQUIRE(task.cancel());
+            REQUIRE_ERROR(co_await task, asyncio::ReceiveError::Cancelled);
+        }
+    }
+}
+
+ASYNC_TEST_CASE("spsc channel concurrency testing", "[channel]") {
+    const auto capacity = GENERATE(take(3, random(1uz, 1024uz)));
+    const auto times = GENERATE(take(3, random(1, 102400)));
+
+    auto [sender, receiver] = asyncio::spscChannel<int>(capacity);
+
+    auto producer = asyncio::toThread([&, sender = std::move(sender)] mutable {
+        for (int i{0}; i < times; ++i)
+            zero::error::guard(sender.sendSync(i));
+
+        sender.close();
+    });
+
+    // Elements must arrive in order, and pending ones are still delivered after the sender closed the channel.
+    for (int i{0}; i < times; ++i) {
+        REQUIRE(co_await receiver.receive() == i);
+    }
+
+    REQUIRE_NOTHROW(co_await producer);
+    REQUIRE_ERROR(co_await receiver.receive(), asyncio::ReceiveError::Disconnected);
+}
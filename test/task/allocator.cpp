@@ -0,0 +1,57 @@
+#include <catch_extensions.h>
+#include <asyncio/task.h>
+
+TEST_CASE("task frame allocator", "[task]") {
+    const auto before = asyncio::task::frameAllocatorStatistics();
+
+    const auto ptr = asyncio::task::allocateFrame(100);
+    REQUIRE(ptr);
+    asyncio::task::deallocateFrame(ptr, 100);
+
+    const auto reused = asyncio::task::allocateFrame(120);
+    REQUIRE(reused);
+    asyncio::task::deallocateFrame(reused, 120);
+
+    const auto after = asyncio::task::frameAllocatorStatistics();
+    REQUIRE(after.allocations - before.allocations == 2);
+    REQUIRE(after.deallocations - before.deallocations == 2);
+
+#ifndef ASYNCIO_DISABLE_FRAME_POOL
+    // The freed frame may have gone back to the heap if the size class was full, but then another one is pooled.
+    REQUIRE(after.hits - before.hits == 1);
+#else
+    REQUIRE(after.hits == before.hits);
+#endif
+}
+
+ASYNC_TEST_CASE("recycle task frames", "[task]") {
+    const auto before = asyncio::task::frameAllocatorStatistics();
+
+    for (int i{0}; i < 10; ++i) {
+        REQUIRE(co_await asyncio::task::spawn([]() -> asyncio::task::Task<void, std::error_code> {
+            co_return {};
+        }));
+    }
+
+    const auto after = asyncio::task::frameAllocatorStatistics();
+    REQUIRE(after.allocations > before.allocations);
+    REQUIRE(after.deallocations > before.deallocations);
+
+#ifndef ASYNCIO_DISABLE_FRAME_POOL
+    REQUIRE(after.hits > before.hits);
+#else
+    REQUIRE(after.hits == before.hits);
+#endif
+}
+
+ASYNC_TEST_CASE("task state shares a single allocation", "[task]") {
+    const auto before = asyncio::task::frameAllocatorStatistics();
+
+    auto task = []() -> asyncio::task::Task<void, std::error_code> {
+        co_return {};
+    }();
+
+    // One for the coroutine frame, one for the task state.
+    REQUIRE(asyncio::task::frameAllocatorStatistics().allocations - before.allocations == 2);
+    REQUIRE(co_await task);
+}
@@ -0,0 +1,30 @@
+#include <catch_extensions.h>
+#include <asyncio/task.h>
+#include <asyncio/time.h>
+#include <thread>
+
+ASYNC_TEST_CASE("task cpu time accounting", "[task]") {
+    asyncio::task::resetCPUTime();
+
+    const auto line = std::source_location::current().line() + 2;
+    REQUIRE(co_await asyncio::task::spawn([]() -> asyncio::task::Task<void, std::error_code> {
+        Z_CO_EXPECT(co_await asyncio::sleep(std::chrono::milliseconds{10}));
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        co_return {};
+    }));
+
+    const auto sites = asyncio::task::cpuTime(1);
+
+#ifdef ASYNCIO_CPU_ACCOUNTING
+    REQUIRE(sites.size() == 1);
+    REQUIRE(sites[0].location.line() == line);
+    REQUIRE(sites[0].resumes == 1);
+    REQUIRE(sites[0].time >= std::chrono::milliseconds{20});
+
+    asyncio::task::resetCPUTime();
+    REQUIRE(asyncio::task::cpuTime().empty());
+#else
+    static_cast<void>(line);
+    REQUIRE(sites.empty());
+#endif
+}
@@ -145,6 +145,96 @@ ASYNC_TEST_CASE("task call tree - error", "[task]") {
     REQUIRE_THAT(task.callTree(), Catch::Matchers::IsEmpty());
 }
 
+ASYNC_TEST_CASE("await task group - error", "[task]") {
+    asyncio::Promise<void, std::error_code> promise1;
+    asyncio::Promise<void, std::error_code> promise2;
+
+    auto task = asyncio::task::spawn([&]() -> asyncio::task::Task<void, std::error_code> {
+        auto task1 = from(asyncio::task::Cancellable{
+            promise1.getFuture(),
+            [&]() -> std::expected<void, std::error_code> {
+                promise1.reject(asyncio::task::Error::Cancelled);
+                return {};
+            }
+        });
+
+        auto task2 = from(asyncio::task::Cancellable{
+            promise2.getFuture(),
+            [&]() -> std::expected<void, std::error_code> {
+                promise2.reject(asyncio::task::Error::Cancelled);
+                return {};
+            }
+        });
+
+        asyncio::task::TaskGroup group;
+        group.add(task1);
+        group.add(task2);
+
+        co_await group;
+        Z_CO_EXPECT(co_await task1);
+        Z_CO_EXPECT(co_await task2);
+        co_return {};
+    });
+
+    // The awaiting task and both members of the group.
+    REQUIRE(task.callTree().size() == 3);
+
+    REQUIRE(task.cancel());
+    REQUIRE_ERROR(co_await task, asyncio::task::Error::Cancelled);
+}
+
+ASYNC_TEST_CASE("resume awaiting task directly - error", "[task]") {
+    asyncio::Promise<void, std::error_code> promise;
+    bool posted{false};
+
+    std::function<asyncio::task::Task<void, std::error_code>(int)> chain = [&](const int depth) -> asyncio::task::Task<void, std::error_code> {
+        if (depth == 0) {
+            Z_CO_EXPECT(co_await promise.getFuture());
+            asyncio::getEventLoop()->post([&] {
+                posted = true;
+            });
+            co_return {};
+        }
+
+        co_return co_await chain(depth - 1);
+    };
+
+    auto task = chain(10);
+    promise.resolve();
+    REQUIRE(co_await task);
+    REQUIRE_FALSE(posted);
+}
+
+ASYNC_TEST_CASE("await task as lvalue - error", "[task]") {
+    asyncio::Promise<void, std::error_code> promise;
+
+    SECTION("copyable") {
+        auto task = [&]() -> asyncio::task::Task<int, std::error_code> {
+            Z_CO_EXPECT(co_await promise.getFuture());
+            co_return 1024;
+        }();
+
+        promise.resolve();
+        REQUIRE(co_await task == 1024);
+        REQUIRE(co_await task == 1024);
+        REQUIRE(co_await task.future() == 1024);
+    }
+
+    SECTION("move only") {
+        auto task = [&]() -> asyncio::task::Task<std::unique_ptr<int>, std::error_code> {
+            Z_CO_EXPECT(co_await promise.getFuture());
+            co_return std::make_unique<int>(1024);
+        }();
+
+        promise.resolve();
+
+        const auto result = co_await task;
+        REQUIRE(result);
+        REQUIRE(**result == 1024);
+        REQUIRE(task.future().isReady());
+    }
+}
+
 ASYNC_TEST_CASE("task all - error", "[task]") {
     SECTION("void") {
         asyncio::Promise<void, std::error_code> promise1;
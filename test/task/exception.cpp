@@ -167,6 +167,28 @@ ASYNC_TEST_CASE("task call tree - exception", "[task]") {
     REQUIRE_THAT(task.callTree(), Catch::Matchers::IsEmpty());
 }
 
+ASYNC_TEST_CASE("resume awaiting task directly - exception", "[task]") {
+    asyncio::Promise<void> promise;
+    bool posted{false};
+
+    std::function<asyncio::task::Task<void>(int)> chain = [&](const int depth) -> asyncio::task::Task<void> {
+        if (depth == 0) {
+            co_await promise.getFuture();
+            asyncio::getEventLoop()->post([&] {
+                posted = true;
+            });
+            co_return;
+        }
+
+        co_await chain(depth - 1);
+    };
+
+    auto task = chain(10);
+    promise.resolve();
+    REQUIRE_NOTHROW(co_await task);
+    REQUIRE_FALSE(posted);
+}
+
 ASYNC_TEST_CASE("task all - exception", "[task]") {
     SECTION("void") {
         asyncio::Promise<void> promise1;
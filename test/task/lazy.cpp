@@ -0,0 +1,130 @@
+#include <catch_extensions.h>
+#include <asyncio/task.h>
+#include <asyncio/error.h>
+
+ASYNC_TEST_CASE("lazy task - error", "[task]") {
+    bool started{false};
+
+    auto lazy = [](bool &flag) -> asyncio::task::Lazy<int, std::error_code> {
+        flag = true;
+        co_return 1024;
+    }(started);
+    REQUIRE_FALSE(started);
+
+    const auto result = co_await std::move(lazy);
+    REQUIRE(started);
+    REQUIRE(result == 1024);
+}
+
+ASYNC_TEST_CASE("lazy task - exception", "[task]") {
+    SECTION("success") {
+        const auto result = co_await []() -> asyncio::task::Lazy<int> {
+            co_return 1024;
+        }();
+        REQUIRE(result == 1024);
+    }
+
+    SECTION("failure") {
+        REQUIRE_THROWS_MATCHES(
+            co_await []() -> asyncio::task::Lazy<void> {
+                throw std::system_error{make_error_code(std::errc::invalid_argument)};
+                co_return;
+            }(),
+            std::system_error,
+            Catch::Matchers::Predicate<std::system_error>([](const auto &error) {
+                return error.code() == std::errc::invalid_argument;
+            })
+        );
+    }
+}
+
+ASYNC_TEST_CASE("nested lazy task", "[task]") {
+    asyncio::Promise<int, std::error_code> promise;
+
+    auto task = asyncio::task::spawn([&]() -> asyncio::task::Task<int, std::error_code> {
+        co_return co_await [](auto future) -> asyncio::task::Lazy<int, std::error_code> {
+            const auto result = co_await [](auto f) -> asyncio::task::Lazy<int, std::error_code> {
+                co_return co_await std::move(f);
+            }(std::move(future));
+            Z_CO_EXPECT(result);
+            co_return *result * 2;
+        }(promise.getFuture());
+    });
+    REQUIRE_FALSE(task.done());
+
+    promise.resolve(512);
+    REQUIRE(co_await task == 1024);
+}
+
+ASYNC_TEST_CASE("cancel lazy task", "[task]") {
+    asyncio::Promise<void, std::error_code> promise;
+
+    auto task = asyncio::task::spawn([&]() -> asyncio::task::Task<void, std::error_code> {
+        co_return co_await [](auto &p) -> asyncio::task::Lazy<void, std::error_code> {
+            co_return co_await asyncio::task::Cancellable{
+                p.getFuture(),
+                [&]() -> std::expected<void, std::error_code> {
+                    p.reject(asyncio::task::Error::Cancelled);
+                    return {};
+                }
+            };
+        }(promise);
+    });
+    REQUIRE_FALSE(task.done());
+    REQUIRE(task.cancel());
+    REQUIRE_ERROR(co_await task, asyncio::task::Error::Cancelled);
+}
+
+ASYNC_TEST_CASE("lazy task interoperability", "[task]") {
+    const auto make = [](const int value) -> asyncio::task::Lazy<int, std::error_code> {
+        co_return value;
+    };
+
+    SECTION("task group") {
+        asyncio::task::TaskGroup group;
+        auto task = group.add(make(1024));
+
+        co_await group;
+        REQUIRE(co_await task == 1024);
+    }
+
+    SECTION("all") {
+        SECTION("variadic") {
+            const auto result = co_await all(make(1), make(2));
+            REQUIRE(result);
+            REQUIRE(*result == std::array{1, 2});
+        }
+
+        SECTION("mixed") {
+            const auto result = co_await all(make(1), from(make(2)));
+            REQUIRE(result);
+            REQUIRE(*result == std::array{1, 2});
+        }
+
+        SECTION("range") {
+            std::vector<asyncio::task::Lazy<int, std::error_code>> lazies;
+            lazies.push_back(make(1));
+            lazies.push_back(make(2));
+
+            const auto result = co_await all(lazies);
+            REQUIRE(result);
+            REQUIRE(*result == std::vector{1, 2});
+        }
+    }
+
+    SECTION("allSettled") {
+        const auto result = co_await allSettled(make(1), make(2));
+        REQUIRE(std::get<0>(result) == 1);
+        REQUIRE(std::get<1>(result) == 2);
+    }
+
+    SECTION("any") {
+        const auto result = co_await any(make(1), make(2));
+        REQUIRE(result == 1);
+    }
+
+    SECTION("race") {
+        const auto result = co_await race(make(1), make(2));
+        REQUIRE(result == 1);
+    }
+}
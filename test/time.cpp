@@ -123,3 +123,143 @@ ASYNC_TEST_CASE("timeout - exception", "[time]") {
         );
     }
 }
+
+ASYNC_TEST_CASE("sleep across wheel levels", "[time]") {
+    using namespace std::chrono_literals;
+
+    std::vector<int> sequence;
+    asyncio::task::TaskGroup group;
+
+    for (const auto ms: {300, 10, 130, 70}) {
+        auto task = asyncio::sleep(std::chrono::milliseconds{ms}).transform([&sequence, ms] {
+            sequence.push_back(ms);
+        });
+        group.add(std::move(task));
+    }
+
+    const auto tp = std::chrono::system_clock::now();
+    co_await group;
+    REQUIRE(std::chrono::system_clock::now() - tp > 295ms);
+    REQUIRE(sequence == std::vector{10, 70, 130, 300});
+    REQUIRE(asyncio::getEventLoop()->timerWheel().size() == 0);
+}
+
+ASYNC_TEST_CASE("cancel sleep", "[time]") {
+    using namespace std::chrono_literals;
+
+    auto task = asyncio::sleep(1h);
+    REQUIRE(asyncio::getEventLoop()->timerWheel().size() == 1);
+    REQUIRE(task.cancel());
+    REQUIRE(asyncio::getEventLoop()->timerWheel().size() == 0);
+    REQUIRE_ERROR(co_await task, std::errc::operation_canceled);
+}
+
+ASYNC_TEST_CASE("interval", "[time]") {
+    using namespace std::chrono_literals;
+
+    asyncio::Interval interval{20ms};
+    REQUIRE(interval.period() == 20ms);
+
+    const auto tp = std::chrono::system_clock::now();
+
+    for (int i{0}; i < 3; ++i)
+        REQUIRE(co_await interval.tick());
+
+    REQUIRE(std::chrono::system_clock::now() - tp > 55ms);
+
+    SECTION("missed ticks collapse") {
+        co_await asyncio::error::guard(asyncio::sleep(70ms));
+        REQUIRE(co_await interval.tick());
+
+        auto task = interval.tick();
+        REQUIRE_FALSE(task.done());
+        REQUIRE(co_await task);
+    }
+
+    SECTION("cancel") {
+        auto task = interval.tick();
+        REQUIRE(task.cancel());
+        REQUIRE_ERROR(co_await task, std::errc::operation_canceled);
+    }
+
+    SECTION("destroyed while ticking") {
+        auto task = interval.tick();
+        interval = asyncio::Interval{1h};
+        REQUIRE_ERROR(co_await task, std::errc::operation_canceled);
+        REQUIRE_FALSE(task.cancel());
+    }
+}
+
+ASYNC_TEST_CASE("deadline", "[time]") {
+    using namespace std::chrono_literals;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    SECTION("not expired") {
+        REQUIRE(co_await asyncio::task::withDeadline(now + 50ms, [] {
+            return asyncio::sleep(10ms);
+        }));
+    }
+
+    SECTION("expired") {
+        REQUIRE_ERROR(
+            co_await asyncio::task::withDeadline(now + 10ms, [] {
+                return asyncio::sleep(50ms);
+            }),
+            asyncio::TimeoutError::Elapsed
+        );
+    }
+
+    SECTION("inherited") {
+        const auto result = co_await asyncio::task::withDeadline(
+            now + 10ms,
+            [=]() -> asyncio::task::Task<void, std::error_code> {
+                REQUIRE(co_await asyncio::task::deadline == now + 10ms);
+
+                co_return co_await asyncio::task::withDeadline(
+                    now + 1h,
+                    [=]() -> asyncio::task::Task<void, std::error_code> {
+                        // The enclosing deadline comes first, so no entry of our own.
+                        REQUIRE(co_await asyncio::task::deadline == now + 10ms);
+                        REQUIRE(asyncio::getEventLoop()->timerWheel().size() == 1);
+                        co_return co_await asyncio::sleep(50ms);
+                    }
+                );
+            }
+        );
+
+        REQUIRE_ERROR(result, asyncio::TimeoutError::Elapsed);
+        REQUIRE(asyncio::getEventLoop()->timerWheel().size() == 0);
+    }
+
+    SECTION("scoped") {
+        REQUIRE(co_await asyncio::task::withDeadline(
+            now + 50ms,
+            []() -> asyncio::task::Task<void, std::error_code> {
+                // Started synchronously but never awaited by `f`, so it runs without the deadline.
+                auto task = []() -> asyncio::task::Task<std::optional<std::chrono::steady_clock::time_point>> {
+                    co_return co_await asyncio::task::deadline;
+                }();
+
+                REQUIRE(co_await asyncio::task::deadline);
+                REQUIRE_FALSE(co_await task);
+                co_return {};
+            }
+        ));
+    }
+
+    SECTION("exception") {
+        REQUIRE_THROWS_MATCHES(
+            co_await asyncio::task::withDeadline(
+                now + 10ms,
+                []() -> asyncio::task::Task<void> {
+                    co_await asyncio::error::guard(asyncio::sleep(50ms));
+                }
+            ),
+            std::system_error,
+            Catch::Matchers::Predicate<std::system_error>([](const auto &error) {
+                return error.code() == asyncio::TimeoutError::Elapsed;
+            })
+        );
+    }
+}
@@ -0,0 +1,56 @@
+#include "catch_extensions.h"
+#include <asyncio/tracer.h>
+#include <asyncio/time.h>
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+TEST_CASE("tracer", "[tracer]") {
+    using namespace std::chrono_literals;
+
+    const auto path = std::filesystem::temp_directory_path() / GENERATE(take(1, randomAlphanumericString(8, 64)));
+
+    {
+        const auto tracer = asyncio::Tracer::make(path, 10ms);
+        REQUIRE(tracer);
+        REQUIRE_ERROR(asyncio::Tracer::make(path), std::errc::device_or_resource_busy);
+
+        const auto result = asyncio::run([]() -> asyncio::task::Task<void, std::error_code> {
+            auto task = asyncio::sleep(1h);
+            REQUIRE(task.cancel());
+            REQUIRE_ERROR(co_await task, std::errc::operation_canceled);
+
+            co_return co_await asyncio::sleep(20ms);
+        });
+        REQUIRE(result);
+        REQUIRE(*result);
+        REQUIRE((*tracer)->dropped() == 0);
+    }
+
+    nlohmann::json events;
+
+    {
+        std::ifstream stream{path};
+        events = nlohmann::json::parse(stream);
+    }
+
+    REQUIRE(std::filesystem::remove(path));
+
+    const auto count = [&](const std::string_view phase, const std::string_view name) {
+        return std::ranges::count_if(events, [&](const auto &event) {
+            return event["ph"] == phase && event["name"] == name;
+        });
+    };
+
+    REQUIRE(count("b", "task") > 0);
+    REQUIRE(count("b", "task") == count("e", "task"));
+    REQUIRE(count("s", "task") == count("f", "task"));
+    REQUIRE(count("s", "await") > 0);
+    REQUIRE(count("s", "await") == count("f", "await"));
+    REQUIRE(count("n", "suspend") > 0);
+    REQUIRE(count("n", "resume") > 0);
+    REQUIRE(count("n", "cancel") > 0);
+    REQUIRE(count("M", "thread_name") == 1);
+    REQUIRE(std::ranges::any_of(events, [](const auto &event) {
+        return event["ph"] == "X" && event["dur"].template get<double>() >= 0;
+    }));
+}
@@ -0,0 +1,175 @@
+#include "catch_extensions.h"
+#include <asyncio/unbounded_channel.h>
+#include <asyncio/thread.h>
+#include <asyncio/error.h>
+
+ASYNC_TEST_CASE("unbounded channel sender", "[channel]") {
+    const auto element = GENERATE(take(1, randomString(1, 1024)));
+
+    auto [sender, receiver] = asyncio::unboundedChannel<std::string>();
+
+    SECTION("send") {
+        // Far more than one segment, none of which may block the sender.
+        for (int i{0}; i < 1000; ++i) {
+            REQUIRE(sender.send(element));
+        }
+
+        REQUIRE(sender.size() == 1000);
+    }
+
+    SECTION("send extended") {
+        SECTION("success") {
+            REQUIRE(sender.sendEx(std::string{element}));
+        }
+
+        SECTION("disconnected") {
+            receiver.close();
+
+            const auto result = sender.sendEx(std::string{element});
+            REQUIRE_FALSE(result);
+
+            const auto &[e, error] = result.error();
+            REQUIRE(e == element);
+            REQUIRE(error == asyncio::SendError::Disconnected);
+        }
+    }
+
+    SECTION("disconnected") {
+        receiver.close();
+        REQUIRE_ERROR(sender.send(element), asyncio::SendError::Disconnected);
+    }
+}
+
+ASYNC_TEST_CASE("unbounded channel receiver", "[channel]") {
+    const auto element = GENERATE(take(1, randomString(1, 1024)));
+
+    auto [sender, receiver] = asyncio::unboundedChannel<std::string>();
+
+    SECTION("try receive") {
+        SECTION("success") {
+            REQUIRE(sender.send(element));
+
+            SECTION("closed") {
+                sender.close();
+            }
+
+            REQUIRE(receiver.tryReceive() == element);
+        }
+
+        SECTION("disconnected") {
+            sender.close();
+            REQUIRE_ERROR(receiver.tryReceive(), asyncio::TryReceiveError::Disconnected);
+        }
+
+        SECTION("empty") {
+            REQUIRE_ERROR(receiver.tryReceive(), asyncio::TryReceiveError::Empty);
+        }
+    }
+
+    SECTION("receive sync") {
+        SECTION("wait") {
+            auto task = asyncio::toThread([&] {
+                return receiver.receiveSync();
+            });
+
+            REQUIRE(sender.send(element));
+            REQUIRE(co_await task == element);
+        }
+
+        SECTION("timeout") {
+            using namespace std::chrono_literals;
+            REQUIRE_ERROR(receiver.receiveSync(10ms), asyncio::ReceiveSyncError::Timeout);
+        }
+    }
+
+    SECTION("receive") {
+        SECTION("wait") {
+            auto task = receiver.receive();
+            REQUIRE_FALSE(task.done());
+
+            REQUIRE(sender.send(element));
+            REQUIRE(co_await task == element);
+        }
+
+        SECTION("disconnected") {
+            auto task = receiver.receive();
+            sender.close();
+            REQUIRE_ERROR(co_await task, asyncio::ReceiveError::Disconnected);
+        }
+
+        SECTION("cancel") {
+            auto task = receiver.receive();
+            REQUIRE(task.cancel());
+            REQUIRE_ERROR(co_await task, asyncio::ReceiveError::Cancelled);
+        }
+    }
+}
+
+ASYNC_TEST_CASE("unbounded channel keeps order across segments", "[channel]") {
+    const auto times = GENERATE(take(3, random(1, 10240)));
+
+    auto [sender, receiver] = asyncio::unboundedChannel<int>();
+
+    // Two bursts, so that the second one runs on recycled segments.
+    for (int round{0}; round < 2; ++round) {
+        for (int i{0}; i < times; ++i) {
+            REQUIRE(sender.send(i));
+        }
+
+        for (int i{0}; i < times; ++i) {
+            REQUIRE(co_await receiver.receive() == i);
+        }
+
+        REQUIRE(receiver.empty());
+    }
+
+    sender.close();
+    REQUIRE_ERROR(co_await receiver.receive(), asyncio::ReceiveError::Disconnected);
+}
+
+ASYNC_TEST_CASE("unbounded channel concurrency testing", "[channel]") {
+    const auto element = GENERATE(take(1, randomString(1, 1024)));
+    const auto times = GENERATE(take(3, random(1, 102400)));
+
+    auto [sender, receiver] = asyncio::unboundedChannel<std::string>();
+
+    std::atomic<int> counter;
+
+    const auto produce = [&] {
+        for (int i{0}; i < times; ++i)
+            zero::error::guard(sender.send(element));
+    };
+
+    const auto consume = [&]() -> asyncio::task::Task<void> {
+        while (true) {
+            const auto result = co_await receiver.receive();
+
+            if (!result) {
+                if (const auto &error = result.error(); error != asyncio::ReceiveError::Disconnected)
+                    throw co_await asyncio::error::StacktraceError<std::system_error>::make(error);
+
+                break;
+            }
+
+            if (*result != element)
+                throw co_await asyncio::error::StacktraceError<std::runtime_error>::make("Received incorrect element");
+
+            ++counter;
+        }
+    };
+
+    std::array producers{asyncio::toThread(produce), asyncio::toThread(produce)};
+    std::array consumers{asyncio::task::spawn(consume), asyncio::task::spawn(consume)};
+
+    for (auto &task: producers) {
+        REQUIRE_NOTHROW(co_await task);
+    }
+
+    sender.close();
+
+    for (auto &task: consumers) {
+        REQUIRE_NOTHROW(co_await task);
+    }
+
+    REQUIRE(counter == times * 2);
+}
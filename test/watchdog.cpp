@@ -0,0 +1,42 @@
+#include "catch_extensions.h"
+#include <asyncio/watchdog.h>
+#include <asyncio/time.h>
+
+TEST_CASE("watchdog", "[watchdog]") {
+    using namespace std::chrono_literals;
+
+    std::mutex mutex;
+    std::vector<asyncio::Watchdog::Stall> stalls;
+
+    asyncio::Watchdog watchdog{
+        50ms,
+        [&](const auto &stall) {
+            const std::lock_guard guard{mutex};
+            stalls.push_back(stall);
+        }
+    };
+
+    const auto eventLoop = std::make_shared<asyncio::EventLoop>(asyncio::EventLoop::make());
+    watchdog.watch(*eventLoop, "main");
+
+    const auto result = asyncio::run(eventLoop, []() -> asyncio::task::Task<void> {
+        // Waiting for I/O is not a stall.
+        co_await asyncio::error::guard(asyncio::sleep(100ms));
+
+        co_await []() -> asyncio::task::Task<void> {
+            co_await asyncio::error::guard(asyncio::reschedule());
+            std::this_thread::sleep_for(200ms);
+        }();
+    });
+    REQUIRE(result);
+
+    const std::lock_guard guard{mutex};
+    REQUIRE(stalls.size() == 1);
+
+    const auto &stall = stalls.front();
+    REQUIRE(stall.name == "main");
+    REQUIRE(stall.duration >= 50ms);
+    REQUIRE(stall.resumed);
+    REQUIRE(stall.backtrace.size() == 1);
+    REQUIRE_FALSE(stall.trace().empty());
+}